@@ -1,40 +1,43 @@
 #include "adaptive_units.hpp"
 #include "graph.hpp"
 #include "label.hpp"
+#include "radix_heap.hpp"
 #include "shared.hpp"
 #include "units.hpp"
 #include "utils.hpp"
 
 #include <optional>
-#include <queue>
 #include <utility>
 
 using namespace std;
 
-// The priority queue element type.
-using pqe_t = std::pair<COST, std::shared_ptr<tn_t> >;
-
-// The priority queue type.
-using pq_t = std::priority_queue<pqe_t, std::vector<pqe_t>,
-                                 std::function<bool(const pqe_t &,
-                                                    const pqe_t &)> >;
+// The priority queue type.  The priorities of the labels created
+// are not smaller than the priority of the label processed, so a
+// monotone queue will do.
+using pq_t = radix_heap<tni_t>;
 
 void
-replenish(const graph &g, const edge &e, const vertex const_v,
-          const label &const_l, const label &other_l,
-          const tnsp_t &tnsp, pq_t &pq, const std::size_t &ncu)
+replenish(const graph &g, search_tree &tree, const edge &e,
+          const vertex const_v, const label &const_l,
+          const label &other_l, tni_t tni, pq_t &pq,
+          const std::size_t &ncu,
+          const std::vector<COST> *dist)
 {
   // The new vertex - target of edge e.
   vertex nv = target(e, g);
+  // The edge ID.
+  eid ei = boost::get(boost::edge_index, g, e);
   // The edge cost.
   auto ec = boost::get(boost::edge_weight, g, e);
   // The edge SU.
   const SU &e_su = boost::get(boost::edge_su, g, e);
   // The new cost.
   auto nc = other_l.first + ec;
+  // The lower bound on the length of the path completed at dst.
+  COST lb = dist ? nc + (*dist)[nv] : nc;
   // The new candidate SU.
   SU n_su = intersection(SU{other_l.second}, e_su);
-  n_su.remove(adaptive_units<COST>::units(ncu, nc));
+  n_su.remove(adaptive_units<COST>::units(ncu, lb));
 
   // Iterate over new candidate CUs.
   for(const auto &n_cu: n_su)
@@ -58,26 +61,21 @@ replenish(const graph &g, const edge &e, const vertex const_v,
         }
 
       // Make sure that e has not been already used.
-      const tn_t *ptr = tnsp.get();
-      for(; ptr != nullptr; ptr = std::get<4>(*ptr).get())
-        if (std::get<2>(*ptr) == e)
-          break;
-
-      // Edge e is not used when we reached the tree root.
-      if (ptr == nullptr)
+      if (!tree.uses(tni, ei))
         {
-          auto sp = make_shared<tn_t>(cvp, clp, e, swapped, tnsp);
+          tni_t n = tree.add(cvp, clp, ei, swapped, tni);
           COST l1 = clp.first.first;
           COST l2 = clp.second.first;
           COST c1 = l1 * adaptive_units<COST>::units(ncu, l1);
           COST c2 = l2 * adaptive_units<COST>::units(ncu, l2);
-          pq.push({c1 + c2, sp});
+          pq.push(to_radix_key(c1 + c2), n);
         }
     }
 }
 
 std::optional<std::pair<cupath, cupath> >
-bf(const graph &g, const demand &d, const CU &cu)
+bf(const graph &g, const std::vector<edge> &es, const demand &d,
+   const CU &cu, const std::vector<COST> *dist)
 {
   std::optional<std::pair<cupath, cupath> > result;
 
@@ -87,27 +85,25 @@ bf(const graph &g, const demand &d, const CU &cu)
   const unsigned &ncu = d.second;
 
   // The priority queue.
-  pq_t pq([](const pqe_t &a, const pqe_t &b)
-          {return !(a.first < b.first);});
+  pq_t pq;
+
+  // The search tree.
+  search_tree tree;
 
   // The boot label.
-  auto blsp = std::make_shared<tn_t>(pair(src, src),
-                                     pair(label(0, cu), label(0, cu)),
-                                     edge(), false, nullptr);
+  tni_t bl = tree.add(pair(src, src), pair(label(0, cu), label(0, cu)),
+                      no_eid, false, no_tni);
 
   // Boot the search with the root of the search tree.
-  pq.push({0, blsp});
+  pq.push(to_radix_key(0), bl);
 
   while(!pq.empty())
     {
-      // Here we get a copy of a shared_ptr.
-      auto pqe = pq.top();
+      tni_t tni = pq.top_value();
       pq.pop();
-      const tnsp_t &tnsp = pqe.second;
-      const tn_t &tn = *tnsp;
 
       // The vertex pair of the tree node.
-      const vertex_pair_t &vp = std::get<0>(tn);
+      const vertex_pair_t vp = tree.vp(tni);
 
       // Vertexes.
       const auto & [v1, v2] = vp;
@@ -115,20 +111,21 @@ bf(const graph &g, const demand &d, const CU &cu)
 
       if (v1 == dst && v2 == dst)
         {
-          result = trace(g, tn, ncu);
+          result = trace(g, es, tree, tni, ncu);
           break;
         }
 
-      // Labels.
-      const auto & [l1, l2] = std::get<1>(tn);
+      // Labels.  They are copied, because the tree grows as we
+      // replenish.
+      const auto [l1, l2] = tree.lp(tni);
 
       // We are leaving vertex v1.
       for(const auto &e: make_iterator_range(out_edges(v1, g)))
-        replenish(g, e, v2, l2, l1, tnsp, pq, ncu);
+        replenish(g, tree, e, v2, l2, l1, tni, pq, ncu, dist);
 
       // We are leaving vertex v2.
       for(const auto &e: make_iterator_range(out_edges(v2, g)))
-        replenish(g, e, v1, l1, l2, tnsp, pq, ncu);
+        replenish(g, tree, e, v1, l1, l2, tni, pq, ncu, dist);
     }
 
   return result;
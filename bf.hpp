@@ -6,8 +6,13 @@
 
 #include <optional>
 #include <utility>
+#include <vector>
 
+// The brute force search.  The edge descriptors es are indexed with
+// the edge ID.  If dist, the shortest distances to dst, is given, the
+// labels are pruned as in gd.
 std::optional<std::pair<cupath, cupath> >
-bf(const graph &g, const demand &d, const CU &cu);
+bf(const graph &g, const std::vector<edge> &es, const demand &d,
+   const CU &cu, const std::vector<COST> *dist = nullptr);
 
 #endif // BF_HPP
@@ -0,0 +1,256 @@
+#ifndef CALENDAR_QUEUE_HPP
+#define CALENDAR_QUEUE_HPP
+
+#include "pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The calendar queue of R. Brown, "Calendar queues: a fast O(1)
+// priority queue implementation for the simulation event set
+// problem", CACM, 1988.  The time is split into days of the bucket
+// width, and the days wrap around a year of the buckets.  A bucket
+// holds a list of the entries sorted by time.  The entries are
+// dequeued in the order of time, and in the order of the push for
+// the same time.
+//
+// The number of buckets is a power of two which follows the size of
+// the queue, and the bucket width is recalculated from the time
+// separation of the earliest entries when the queue is resized.  The
+// list nodes come from a pool, so a queue which has reached its peak
+// size allocates no memory.
+//
+// T is the time type, non-negative, and V is the value type.
+template <typename T, typename V>
+class calendar_queue
+{
+  // The list node of an entry.
+  struct node
+  {
+    T m_t;
+    // The sequence number, which orders the entries of the same time.
+    std::uint64_t m_seq;
+    V m_v;
+    node *m_next;
+  };
+
+  // The minimal number of buckets.
+  static constexpr std::size_t m_min_buckets = 2;
+
+  // The number of entries sampled to calculate the bucket width.
+  static constexpr std::size_t m_samples = 25;
+
+  // The pool of nodes.
+  pool<node> m_pool;
+
+  // The buckets, i.e., the heads of the lists.
+  std::vector<node *> m_buckets;
+
+  // The bucket width.
+  T m_width = 1;
+
+  // The current day: the number of the bucket width that the time of
+  // the first entry is not earlier than.
+  std::uint64_t m_day = 0;
+
+  // The number of entries.
+  std::size_t m_size = 0;
+
+  // The sequence number of the next entry pushed.
+  std::uint64_t m_seq = 0;
+
+  // The node of the first entry, if found, otherwise null.
+  node *m_first = nullptr;
+
+public:
+  calendar_queue(): m_buckets(m_min_buckets)
+  {
+  }
+
+  calendar_queue(const calendar_queue &) = delete;
+
+  ~calendar_queue()
+  {
+    for (node *h: m_buckets)
+      while (h)
+        {
+          node *n = h->m_next;
+          m_pool.destroy(h);
+          h = n;
+        }
+  }
+
+  bool
+  empty() const
+  {
+    return !m_size;
+  }
+
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  void
+  push(T t, const V &v)
+  {
+    assert(t >= 0);
+
+    node *n = m_pool.create(node{t, m_seq++, v, nullptr});
+
+    // An entry earlier than the current day moves the day back.
+    if (day(t) < m_day)
+      m_day = day(t);
+
+    insert(n);
+    ++m_size;
+    m_first = nullptr;
+
+    if (m_size > 2 * m_buckets.size())
+      resize(2 * m_buckets.size());
+  }
+
+  // The time of the first entry.  The queue cannot be empty.
+  T
+  top_time()
+  {
+    return first()->m_t;
+  }
+
+  // The value of the first entry.  The queue cannot be empty.
+  const V &
+  top_value()
+  {
+    return first()->m_v;
+  }
+
+  // Remove the first entry.  The queue cannot be empty.
+  void
+  pop()
+  {
+    node *n = first();
+    node *&h = m_buckets[m_day & mask()];
+    assert(h == n);
+    h = n->m_next;
+    m_pool.destroy(n);
+    --m_size;
+    m_first = nullptr;
+
+    if (m_buckets.size() > m_min_buckets && m_size < m_buckets.size() / 2)
+      resize(m_buckets.size() / 2);
+  }
+
+private:
+  std::size_t
+  mask() const
+  {
+    return m_buckets.size() - 1;
+  }
+
+  std::uint64_t
+  day(T t) const
+  {
+    return static_cast<std::uint64_t>(t / m_width);
+  }
+
+  static bool
+  before(const node *a, const node *b)
+  {
+    return a->m_t < b->m_t || (a->m_t == b->m_t && a->m_seq < b->m_seq);
+  }
+
+  // Insert the node into its bucket, keeping the list sorted.
+  void
+  insert(node *n)
+  {
+    node **p = &m_buckets[day(n->m_t) & mask()];
+    while (*p && before(*p, n))
+      p = &(*p)->m_next;
+    n->m_next = *p;
+    *p = n;
+  }
+
+  // Find the first entry, and set the current day to its day.
+  node *
+  first()
+  {
+    assert(m_size);
+
+    if (m_first)
+      return m_first;
+
+    // Look at the buckets of the days of the current year.
+    for (std::size_t i = 0; i < m_buckets.size(); ++i, ++m_day)
+      {
+        node *h = m_buckets[m_day & mask()];
+        if (h && day(h->m_t) == m_day)
+          return m_first = h;
+      }
+
+    // The year is empty, so search all buckets directly.
+    node *m = nullptr;
+    for (node *h: m_buckets)
+      if (h && (!m || before(h, m)))
+        m = h;
+
+    m_day = day(m->m_t);
+    return m_first = m;
+  }
+
+  // Rebuild the queue with the given number of buckets.
+  void
+  resize(std::size_t nb)
+  {
+    std::vector<node *> ns;
+    ns.reserve(m_size);
+    for (node *h: m_buckets)
+      for (; h; h = h->m_next)
+        ns.push_back(h);
+
+    std::sort(ns.begin(), ns.end(), before);
+    m_width = width(ns);
+    m_buckets.assign(nb, nullptr);
+
+    // Insert in the reversed order, so that the lists are built at
+    // their heads.
+    for (auto i = ns.rbegin(); i != ns.rend(); ++i)
+      insert(*i);
+
+    m_day = ns.empty() ? 0 : day(ns.front()->m_t);
+    m_first = nullptr;
+  }
+
+  // Calculate the bucket width as three times the mean separation of
+  // the earliest entries, ignoring the separations greater than twice
+  // the mean, as proposed by Brown.  The nodes are sorted.
+  T
+  width(const std::vector<node *> &ns) const
+  {
+    std::size_t k = std::min(ns.size(), m_samples);
+    if (k < 2)
+      return m_width;
+
+    T sum = ns[k - 1]->m_t - ns[0]->m_t;
+    T mean = sum / (k - 1);
+
+    T s = 0;
+    std::size_t c = 0;
+    for (std::size_t i = 1; i < k; ++i)
+      if (T d = ns[i]->m_t - ns[i - 1]->m_t; d <= 2 * mean)
+        {
+          s += d;
+          ++c;
+        }
+
+    if (!c || s <= 0)
+      return m_width;
+
+    return 3 * s / c;
+  }
+};
+
+#endif // CALENDAR_QUEUE_HPP
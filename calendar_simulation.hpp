@@ -0,0 +1,80 @@
+#ifndef CALENDAR_SIMULATION_HPP
+#define CALENDAR_SIMULATION_HPP
+
+#include "calendar_queue.hpp"
+#include "module.hpp"
+
+// The simulation with the same interface as the simulation of the
+// des library, but with the calendar queue as the event list.  An
+// event is the time and the module to call, kept in a pooled node,
+// so scheduling an event allocates no memory in the steady state,
+// and takes O(1) expected time.
+template <typename T, typename M, typename R>
+class calendar_simulation
+{
+public:
+  typedef T time_type;
+  typedef M model_type;
+  typedef R rne_type;
+  typedef calendar_simulation<T, M, R> self;
+  typedef module<self> module_type;
+
+protected:
+  // The event list.
+  static inline calendar_queue<time_type, module_type *> m_q;
+
+  // The current time.
+  static inline time_type m_now;
+
+  // The model.
+  static inline model_type m_mdl;
+
+  // The random number engine.
+  static inline rne_type m_rne;
+
+public:
+  static model_type &
+  mdl()
+  {
+    return m_mdl;
+  }
+
+  static rne_type &
+  rne()
+  {
+    return m_rne;
+  }
+
+  static const time_type &
+  now()
+  {
+    return m_now;
+  }
+
+  // Schedule the module to be called at time t.
+  static void
+  schedule(time_type t, module_type *m)
+  {
+    m_q.push(t, m);
+  }
+
+  // Run the simulation until there are no events, or the time of the
+  // next event is past the limit.
+  static void
+  run(time_type limit)
+  {
+    while(!m_q.empty())
+      {
+        time_type t = m_q.top_time();
+        if (t > limit)
+          break;
+
+        module_type *m = m_q.top_value();
+        m_q.pop();
+        m_now = t;
+        (*m)(m_now);
+      }
+  }
+};
+
+#endif // CALENDAR_SIMULATION_HPP
@@ -4,10 +4,12 @@
 #include "routing.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include <boost/program_options.hpp>
 
@@ -18,8 +20,27 @@
 #define ST_S "st"
 #define POPULATION_S "population"
 #define GD_S "gd"
+#define GDB_S "gdb"
 #define BF_S "bf"
 #define EE_S "ee"
+#define KSP_S "ksp"
+#define SW_S "sw"
+#define PREPASS_S "prepass"
+#define GD_LABELS_S "gd_labels"
+#define GD_TIME_S "gd_time"
+#define GD_THREADS_S "gd_threads"
+#define GD_INCREMENTAL_S "gd_incremental"
+#define GD_CACHE_S "gd_cache"
+#define GD_LEARN_S "gd_learn"
+#define GD_VERIFY_S "gd_verify"
+#define SAMPLES_S "samples"
+#define STREAM_S "stream"
+#define RECORD_S "record"
+#define REPLAY_S "replay"
+#define SPECULATE_S "speculate"
+#define THREADS_S "threads"
+#define SNAPSHOT_S "snapshot"
+#define SNAPSHOT_TIME_S "snapshot_time"
 
 using namespace std;
 namespace po = boost::program_options;
@@ -46,8 +67,40 @@ process_cli_args(int argc, const char *argv[])
          "the number of units")
 
         (GD_S, "run the generic Dijkstra search")
+        (GDB_S, po::value<unsigned>(),
+         "run the generic Dijkstra search with the given beam")
         (BF_S, "corroborate with the brute force search")
-        (EE_S, "run the edge exclusion search");
+        (EE_S, "run the edge exclusion search")
+        (KSP_S, po::value<unsigned>(),
+         "run the search over the given number of the precomputed "
+         "path pairs per node pair")
+        (SW_S, "run the slot window search of the fixed modulation")
+
+        (PREPASS_S, "run the feasibility pre-pass before the searches")
+
+        (GD_LABELS_S, po::value<unsigned long>(),
+         "the max number of labels of the generic Dijkstra search")
+
+        (GD_TIME_S, po::value<double>(),
+         "the max time in seconds of the generic Dijkstra search")
+
+        (GD_THREADS_S, po::value<unsigned>()->default_value(1),
+         "the number of threads of a generic Dijkstra search, "
+         "and of a slot window search")
+
+        (GD_INCREMENTAL_S, "repair the last generic Dijkstra search "
+         "from the source, if it was for the same demand")
+
+        (GD_CACHE_S, "reuse the last generic Dijkstra result for the "
+         "same demand, if the edges it depended on have not changed")
+
+        (GD_LEARN_S, po::value<unsigned>(),
+         "fit the demand into the given number of the path pairs per "
+         "node pair learned from the generic Dijkstra results first")
+
+        (GD_VERIFY_S, po::value<unsigned>()->default_value(10),
+         "check every given fit into the learned path pairs against "
+         "the generic Dijkstra search, 0 for none");
 
       // Traffic options.
       po::options_description tra("Traffic options");
@@ -59,7 +112,20 @@ process_cli_args(int argc, const char *argv[])
          "the mean holding time")
 
         ("mnu", po::value<double>()->required(),
-         "the mean number of units");
+         "the mean number of units")
+
+        (RECORD_S, po::value<string>(),
+         "record the arrivals to the workload file")
+
+        (REPLAY_S, po::value<string>(),
+         "replay the arrivals from the workload file")
+
+        (SPECULATE_S, po::value<unsigned>(),
+         "search for the given number of the arrivals replayed "
+         "in parallel")
+
+        (THREADS_S, po::value<unsigned>(),
+         "the number of threads of the speculative searches");
 
       // Simulation options.
       po::options_description sim("Simulation options");
@@ -68,7 +134,19 @@ process_cli_args(int argc, const char *argv[])
          "the seed of the random number generator")
 
         (POPULATION_S, po::value<string>()->required(),
-         "the population name");
+         "the population name")
+
+        (SAMPLES_S, po::value<int>()->default_value(100),
+         "the number of measurements of the network state")
+
+        (STREAM_S, po::value<string>(),
+         "stream the measurements to the CSV file")
+
+        (SNAPSHOT_S, po::value<string>(),
+         "save the snapshot of the network state to the file")
+
+        (SNAPSHOT_TIME_S, po::value<double>(),
+         "the simulation time of the snapshot");
 
       po::options_description all("Allowed options");
       all.add(gen).add(net).add(tra).add(sim);
@@ -90,6 +168,18 @@ process_cli_args(int argc, const char *argv[])
       if (vm.count(GD_S))
         result.gd = true;
 
+      // The search options.
+      if (vm.count(GDB_S))
+        {
+          result.gdb = vm[GDB_S].as<unsigned>();
+
+          if (!result.gdb)
+            {
+              cerr << "The beam of --" GDB_S " should be positive.\n";
+              exit(1);
+            }
+        }
+
       // The search options.
       if (vm.count(BF_S))
         result.bf = true;
@@ -98,11 +188,34 @@ process_cli_args(int argc, const char *argv[])
       if (vm.count(EE_S))
         result.ee = true;
 
+      // The search options.
+      if (vm.count(KSP_S))
+        {
+          result.ksp = vm[KSP_S].as<unsigned>();
+
+          if (!result.ksp)
+            {
+              cerr << "The number of path pairs of --" KSP_S
+                " should be positive.\n";
+              exit(1);
+            }
+        }
+
+      // The search options.
+      if (vm.count(SW_S))
+        result.sw = true;
+
       // Let's check the combinations of the search algorithms.
-      if (!result.gd && !result.ee)
+      if (!result.gd && !result.gdb && !result.ee && !result.ksp &&
+          !result.sw)
         {
           cout << "You have the following search options:\n";
           cout << "* --gd to run the generic Dijkstra search only,\n";
+          cout << "* --gdb B to run the generic Dijkstra search with\n"
+            "  the beam of B labels per vertex pair only,\n";
+          cout << "* --ksp K to run the search over K precomputed\n"
+            "  path pairs per node pair only,\n";
+          cout << "* --sw to run the slot window search only,\n";
           cout << "* --ee to run the edge exclusion search only,\n";
           cout << "* --gd --ee to run both searches.\n\n";
           cout <<
@@ -112,11 +225,77 @@ process_cli_args(int argc, const char *argv[])
           cout <<
             "If you use both --gd and --ee, the connection will be\n"
             "established with the path found by the generic\n"
-            "Dijkstra search.\n";
+            "Dijkstra search.\n\n";
+          cout <<
+            "If you use both --gd and --gdb, the results of the\n"
+            "beam search are compared with the exact results, and\n"
+            "so are the results of --ksp and --sw.\n";
           cout.flush();
           exit(0);
         }
 
+      // The feasibility pre-pass.
+      if (vm.count(PREPASS_S))
+        result.prepass = true;
+
+      // The budget of the generic Dijkstra search.
+      if (vm.count(GD_LABELS_S))
+        result.gd_labels = vm[GD_LABELS_S].as<unsigned long>();
+
+      if (vm.count(GD_TIME_S))
+        result.gd_time = vm[GD_TIME_S].as<double>();
+
+      result.gd_threads = max(1u, vm[GD_THREADS_S].as<unsigned>());
+
+      // The incremental search is exact, and so it can't be used
+      // with the budget.
+      if (vm.count(GD_INCREMENTAL_S))
+        {
+          if (!result.gd || result.gd_labels || result.gd_time > 0)
+            {
+              cerr << "Use --" GD_INCREMENTAL_S " with --" GD_S
+                ", with no budget.\n";
+              exit(1);
+            }
+
+          result.gd_incremental = true;
+        }
+
+      // The cached results are exact too.
+      if (vm.count(GD_CACHE_S))
+        {
+          if (!result.gd || result.gd_labels || result.gd_time > 0)
+            {
+              cerr << "Use --" GD_CACHE_S " with --" GD_S
+                ", with no budget.\n";
+              exit(1);
+            }
+
+          result.gd_cache = true;
+        }
+
+      // The fits are checked against the exact results.
+      if (vm.count(GD_LEARN_S))
+        {
+          result.gd_learn = vm[GD_LEARN_S].as<unsigned>();
+
+          if (!result.gd_learn)
+            {
+              cerr << "The number of path pairs of --" GD_LEARN_S
+                " should be positive.\n";
+              exit(1);
+            }
+
+          if (!result.gd || result.gd_labels || result.gd_time > 0)
+            {
+              cerr << "Use --" GD_LEARN_S " with --" GD_S
+                ", with no budget.\n";
+              exit(1);
+            }
+
+          result.gd_verify = vm[GD_VERIFY_S].as<unsigned>();
+        }
+
       // The network options.
       result.net = vm[NET_S].as<string>();
 
@@ -127,9 +306,66 @@ process_cli_args(int argc, const char *argv[])
       result.mht = vm["mht"].as<double>();
       result.mnu = vm["mnu"].as<double>();
 
+      if (vm.count(RECORD_S) && vm.count(REPLAY_S))
+        {
+          cerr << "Use either --" RECORD_S " or --" REPLAY_S ".\n";
+          exit(1);
+        }
+
+      if (vm.count(RECORD_S))
+        result.record = vm[RECORD_S].as<string>();
+
+      if (vm.count(REPLAY_S))
+        result.replay = vm[REPLAY_S].as<string>();
+
+      // The speculative searches run ahead of the arrivals, which are
+      // known in the replay mode only.  Only the results of the exact
+      // generic Dijkstra search can be validated.
+      if (vm.count(SPECULATE_S))
+        {
+          result.speculate = vm[SPECULATE_S].as<unsigned>();
+
+          if (result.speculate &&
+              (result.replay.empty() || !result.gd || result.bf ||
+               result.ee || result.gdb || result.ksp || result.sw ||
+               result.gd_learn || result.gd_labels ||
+               result.gd_time > 0))
+            {
+              cerr << "Use --" SPECULATE_S " with --" REPLAY_S
+                " and --" GD_S " only, with no budget.\n";
+              exit(1);
+            }
+        }
+
+      result.threads = vm.count(THREADS_S) ?
+        vm[THREADS_S].as<unsigned>() : thread::hardware_concurrency();
+      result.threads = max(1u, result.threads);
+
       // The simulation options.
       result.seed = vm["seed"].as<int>();
       result.population = vm[POPULATION_S].as<string>();
+      result.samples = vm[SAMPLES_S].as<int>();
+
+      if (result.samples < 1)
+        {
+          cerr << "Use --" SAMPLES_S " with a positive number.\n";
+          exit(1);
+        }
+
+      if (vm.count(STREAM_S))
+        result.stream = vm[STREAM_S].as<string>();
+
+      if (vm.count(SNAPSHOT_S) != vm.count(SNAPSHOT_TIME_S))
+        {
+          cerr << "Use --" SNAPSHOT_S " with --" SNAPSHOT_TIME_S ".\n";
+          exit(1);
+        }
+
+      if (vm.count(SNAPSHOT_S))
+        {
+          result.snapshot = vm[SNAPSHOT_S].as<string>();
+          result.snapshot_time = vm[SNAPSHOT_TIME_S].as<double>();
+        }
     }
   catch(const std::exception& e)
     {
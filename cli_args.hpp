@@ -32,6 +32,45 @@ struct cli_args
   // Use the edge exclusion search.
   bool ee = false;
 
+  // Use the slot window search.
+  bool sw = false;
+
+  // Run the feasibility pre-pass before the searches.
+  bool prepass = false;
+
+  // The beam of the generic Dijkstra search with the beam, 0 if the
+  // search is not used.
+  unsigned gdb = 0;
+
+  // The number of the precomputed path pairs per node pair of the k
+  // shortest path pairs search, 0 if the search is not used.
+  unsigned ksp = 0;
+
+  // The max number of labels made permanent by the generic Dijkstra
+  // search, 0 for no limit.
+  unsigned long gd_labels = 0;
+
+  // The max time in seconds of the generic Dijkstra search, 0 for no
+  // limit.
+  double gd_time = 0;
+
+  // The number of threads of a generic Dijkstra search.
+  unsigned gd_threads = 1;
+
+  // Repair the last generic Dijkstra search from the source.
+  bool gd_incremental = false;
+
+  // Reuse the cached generic Dijkstra results.
+  bool gd_cache = false;
+
+  // The number of the path pairs learned per node pair from the
+  // generic Dijkstra results, 0 if not used.
+  unsigned gd_learn = 0;
+
+  // Check every gd_verify-th fit into the learned path pairs against
+  // the exact result, 0 for none.
+  unsigned gd_verify = 0;
+
   /// -----------------------------------------------------------------
   /// The traffic options
   /// -----------------------------------------------------------------
@@ -48,6 +87,21 @@ struct cli_args
   /// The mean number of units.
   double mnu;
 
+  /// The file name to record the arrivals to.  Empty if the
+  /// recording is not requested.
+  std::string record;
+
+  /// The file name to replay the arrivals from.  Empty if the replay
+  /// is not requested.
+  std::string replay;
+
+  /// The number of the arrivals replayed, whose searches are run in
+  /// parallel ahead of time, 0 if the speculation is not requested.
+  unsigned speculate = 0;
+
+  /// The number of threads of the speculative searches.
+  unsigned threads = 0;
+
   /// -----------------------------------------------------------------
   /// The simulation options
   /// -----------------------------------------------------------------
@@ -63,6 +117,20 @@ struct cli_args
 
   /// The limit on the simulation time.
   double sim_time;
+
+  /// The number of instantaneous measurements of the network state.
+  int samples;
+
+  /// The file name of the stream of the measurements.  Empty if the
+  /// stream is not requested.
+  std::string stream;
+
+  /// The file name of the snapshot of the network state.  Empty if
+  /// the snapshot is not requested.
+  std::string snapshot;
+
+  /// The simulation time of the snapshot.
+  double snapshot_time;
 };
 
 /**
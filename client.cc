@@ -12,19 +12,16 @@
 
 using namespace std;
 
-client::client(double mht, double mnu, traffic &tra):
-  m_htd(1 / mht), m_nud(mnu - 1),
-  conn(m_mdl), tra(tra)
+client::client(const demand &d, const optional<double> &ht,
+               traffic &tra): conn(m_mdl), tra(tra)
 {
   // Try to setup the connection.
-  if (set_up())
+  if (conn.establish(d))
     {
       // Register the client with the traffic.
       tra.insert(this);
-      // Holding time.
-      double ht = m_htd(m_rne);
       // Tear down time.
-      tdt = now() + ht;
+      tdt = now() + (ht ? ht.value() : tra.draw_holding_time());
       schedule(tdt);
     }
   else
@@ -38,30 +35,24 @@ void client::operator()(double t)
   destroy();
 }
 
-bool client::set_up()
-{
-  // The new demand.
-  demand d;
-  // The demand end nodes.
-  d.first = random_node_pair(m_mdl, m_rne);
-  // The number of units the signal requires.  It's Poisson + 1.
-  d.second = m_nud(m_rne) + 1;
-
-  // Set up the connection.
-  return conn.establish(d);
-}
-
 const connection &
 client::get_connection() const
 {
   return conn;
 }
 
+double
+client::get_tdt() const
+{
+  return tdt;
+}
+
 void
 client::destroy()
 {
   assert(conn.is_established());
-  conn.tear_down();
+  // Erase first, so that the traffic can account for the connection.
   tra.erase(this);
+  conn.tear_down();
   tra.delete_me_later(this);
 }
@@ -8,7 +8,7 @@
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
-#include <random>
+#include <optional>
 #include <utility>
 
 namespace ba = boost::accumulators;
@@ -21,35 +21,43 @@ class traffic;
  */
 class client: public module<sim>
 {
+  // The traffic keeps the active clients on an intrusive list.
+  friend class traffic;
+
   // The client ID.
   int id;
 
   // The tear down time.
   double tdt;
 
-  // The holding time distribution.
-  std::exponential_distribution<> m_htd;
-
-  // The number of units distribution.
-  std::poisson_distribution<> m_nud;
-
   // The connection.
   connection conn;
 
   // The traffic object the client belongs to.
   traffic &tra;
-  
+
+  // The previous and the next client on the list of active clients.
+  client *m_prev = nullptr;
+  client *m_next = nullptr;
+
 public:
-  client(double mht, double mnu, traffic &tra);
-  
+  // The client tries to establish the connection for demand d.  If
+  // successful, the connection is held for the holding time ht, or
+  // for the holding time drawn by the traffic, if ht has no value.
+  client(const demand &d, const std::optional<double> &ht,
+         traffic &tra);
+
   // Processes the event and changes the state of the client.
   void operator()(double t);
 
   const connection &
   get_connection() const;
 
+  // The tear down time.
+  double
+  get_tdt() const;
+
 private:
-  bool set_up();
   void destroy();
 };
 
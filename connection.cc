@@ -11,6 +11,8 @@ using namespace std;
 
 int connection::counter = 0;
 
+eid_arena connection::arena;
+
 connection::connection(graph &g): m_g(g), m_id(counter++)
 {
 }
@@ -30,14 +32,33 @@ connection::get_demand() const
 bool
 connection::is_established() const
 {
-  return m_p.has_value();
+  return m_established;
+}
+
+cupp
+connection::get_cupp() const
+{
+  assert(is_established());
+
+  cupp result;
+  cupath *ps[] = {&result.first, &result.second};
+  const eid *ids = arena.data(m_off);
+
+  for (int i = 0; i < 2; ++i)
+    {
+      ps[i]->first = m_cus[i];
+      for (unsigned j = 0; j < m_hops[i]; ++j)
+        ps[i]->second.push_back(routing::get_edge(*ids++));
+    }
+
+  return result;
 }
 
 COST
 connection::get_cost() const
 {
   assert(is_established());
-  return ::get_cost(m_g, m_p.value());
+  return m_costs[0] + m_costs[1];
 }
 
 bool
@@ -50,7 +71,28 @@ connection::establish(const demand &d)
   m_d = d;
 
   // Set up the demand.
-  m_p = routing::set_up(m_g, d);
+  optional<cupp> p = routing::set_up(m_g, d);
+
+  if (p)
+    {
+      const cupath *ps[] = {&p.value().first, &p.value().second};
+
+      for (int i = 0; i < 2; ++i)
+        {
+          m_cus[i] = ps[i]->first;
+          m_costs[i] = ::get_cost(m_g, *ps[i]);
+          m_hops[i] = ps[i]->second.size();
+        }
+
+      m_off = arena.allocate(m_hops[0] + m_hops[1]);
+      eid *ids = arena.data(m_off);
+
+      for (const cupath *cp: ps)
+        for (const auto &e: cp->second)
+          *ids++ = boost::get(boost::edge_index, m_g, e);
+
+      m_established = true;
+    }
 
   return is_established();
 }
@@ -59,6 +101,12 @@ void
 connection::tear_down()
 {
   assert(is_established());
-  routing::tear_down(m_g, m_p.value());
-  m_p.reset();
+
+  const eid *ids = arena.data(m_off);
+  routing::tear_down(m_g, m_cus[0], ids, ids + m_hops[0]);
+  routing::tear_down(m_g, m_cus[1], ids + m_hops[0],
+                     ids + m_hops[0] + m_hops[1]);
+
+  arena.free(m_off, m_hops[0] + m_hops[1]);
+  m_established = false;
 }
@@ -1,6 +1,7 @@
 #ifndef CONNECTION_HPP
 #define CONNECTION_HPP
 
+#include "eid_arena.hpp"
 #include "graph.hpp"
 
 #include <optional>
@@ -8,6 +9,11 @@
 
 // The type of the connection.  It can establish, reconfigure and tear
 // down a connection, but it doesn't report the statistics.
+//
+// The connection keeps the CUs, the costs and the numbers of hops of
+// the paths, and the edge IDs of the paths in a span of the arena
+// shared by all connections: first the working path, then the backup
+// path.
 class connection
 {
 public:
@@ -20,6 +26,11 @@ public:
   bool
   is_established() const;
 
+  // The path pair of the established connection, with the edge
+  // descriptors looked up.
+  cupp
+  get_cupp() const;
+
   // Establish the connection for the given demand.  True if
   // successful.  If unsuccessful, the state of the object doesn't
   // change.
@@ -28,7 +39,8 @@ public:
 
   // Return the cost of the protected connection.  The cost is the sum
   // of the costs of both paths.  A cost of a path is the product of
-  // length and the number of units.
+  // length and the number of units.  The cost is calculated once,
+  // when the connection is established.
   COST
   get_cost() const;
 
@@ -38,11 +50,25 @@ public:
 private:
   graph &m_g;
   demand m_d;
-  std::optional<cupp> m_p;
+
+  // True if the connection is established.
+  bool m_established = false;
+
+  // The CUs, the costs, and the numbers of hops of the working and
+  // the backup paths.
+  CU m_cus[2];
+  COST m_costs[2];
+  unsigned m_hops[2];
+
+  // The offset of the span of the edge IDs in the arena.
+  unsigned m_off;
 
   int m_id;
 
   static int counter;
+
+  // The edge IDs of the paths of all connections.
+  static eid_arena arena;
 };
 
 #endif /* CONNECTION_HPP */
@@ -2,9 +2,12 @@
 #include "cli_args.hpp"
 #include "graph.hpp"
 #include "sim.hpp"
+#include "snapshot_taker.hpp"
 #include "stats.hpp"
 #include "utils.hpp"
 
+#include <optional>
+
 using namespace std;
 
 int
@@ -15,12 +18,35 @@ simulate(const cli_args &args_para)
   if (args.gd)
     routing::add_algorithm(routing::rt_t::gd);
 
+  if (args.gdb)
+    {
+      routing::add_algorithm(routing::rt_t::gdb);
+      routing::set_beam(args.gdb);
+    }
+
   if (args.bf)
     routing::add_algorithm(routing::rt_t::bf);
 
   if (args.ee)
     routing::add_algorithm(routing::rt_t::ee);
 
+  if (args.ksp)
+    {
+      routing::add_algorithm(routing::rt_t::ksp);
+      routing::set_ksp(args.ksp);
+    }
+
+  if (args.sw)
+    routing::add_algorithm(routing::rt_t::sw);
+
+  routing::set_budget(args.gd_labels, args.gd_time);
+  routing::set_prepass(args.prepass);
+  routing::set_gd_threads(args.gd_threads);
+  routing::set_incremental(args.gd_incremental);
+  routing::set_cache(args.gd_cache);
+  routing::set_learn(args.gd_learn, args.gd_verify);
+  routing::set_threads(args.threads);
+
   // Initialize the random number engine of the simulation.
   sim::rne().seed(args.seed);
 
@@ -33,6 +59,9 @@ simulate(const cli_args &args_para)
 
   set_units(g, args.units);
 
+  // Start keeping track of the spectrum occupancy.
+  routing::init(g);
+
   // Make sure there is only one component.
   assert(is_connected(g));
 
@@ -54,11 +83,17 @@ simulate(const cli_args &args_para)
   args.sim_time = 15 * args.mht;
 
   // The traffic module.
-  traffic t(args.mcat, args.mht, args.mnu);
+  traffic t(args.mcat, args.mht, args.mnu, args.record, args.replay,
+            args.speculate);
 
   // The stats module.
   stats s(args, t);
 
+  // The snapshot module, if requested.
+  optional<snapshot_taker> st;
+  if (!args.snapshot.empty())
+    st.emplace(args.snapshot, args.snapshot_time, t);
+
   // Run the simulation.
   sim::run(args.sim_time);
 
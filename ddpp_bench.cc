@@ -0,0 +1,400 @@
+// The micro-benchmark of the routing searches.  It loads a network,
+// the state of the spectrum, and a list of demands, and then runs the
+// searches for the demands repeatedly, with no simulation around.
+// The results are reported in JSON.
+
+#include "adaptive_units.hpp"
+#include "bf.hpp"
+#include "dist_table.hpp"
+#include "ee.hpp"
+#include "gd.hpp"
+#include "graph.hpp"
+#include "ksp.hpp"
+#include "occupancy.hpp"
+#include "snapshot.hpp"
+#include "sw.hpp"
+#include "utils.hpp"
+
+#include <boost/program_options.hpp>
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace po = boost::program_options;
+
+// The number of memory allocations made.  All forms of the operators
+// new and delete are replaced, so that every allocation is counted,
+// and freed with the matching function.
+static atomic<unsigned long> allocations;
+
+static void *
+allocate(size_t size)
+{
+  ++allocations;
+
+  if (void *p = malloc(size ? size : 1))
+    return p;
+
+  throw bad_alloc();
+}
+
+void *
+operator new(size_t size)
+{
+  return allocate(size);
+}
+
+void *
+operator new[](size_t size)
+{
+  return allocate(size);
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p, size_t) noexcept
+{
+  free(p);
+}
+
+// The benchmark arguments.
+struct bench_args
+{
+  // The network file name.
+  string net;
+  // The number of units.
+  int units;
+  // The snapshot file name of the spectrum state, empty if all units
+  // are available.
+  string state;
+  // The demands file name.
+  string demands;
+  // The algorithms to run.
+  vector<string> algs;
+  // The beam of the generic Dijkstra search with the beam.
+  unsigned beam;
+  // The number of the path pairs per node pair of the k shortest path
+  // pairs search.
+  unsigned k;
+  // The number of threads of a generic Dijkstra search, of a slot
+  // window search, and of building the table of the path pairs.
+  unsigned threads;
+  // The number of warm-up runs.
+  int warmup;
+  // The number of measured runs.
+  int reps;
+};
+
+bench_args
+process_bench_args(int argc, const char *argv[])
+{
+  bench_args result;
+
+  po::options_description opts("Allowed options");
+  opts.add_options()
+    ("help,h", "produce help message")
+
+    ("net", po::value<string>(&result.net)->required(),
+     "the network file name")
+
+    ("units", po::value<int>(&result.units)->required(),
+     "the number of units")
+
+    ("state", po::value<string>(&result.state),
+     "the snapshot file name of the spectrum state")
+
+    ("demands", po::value<string>(&result.demands)->required(),
+     "the demands file name")
+
+    ("gd", "run the generic Dijkstra search")
+    ("gdb", po::value<unsigned>(&result.beam),
+     "run the generic Dijkstra search with the given beam")
+    ("bf", "run the brute force search")
+    ("ee", "run the edge exclusion search")
+    ("ksp", po::value<unsigned>(&result.k),
+     "run the search over the given number of the precomputed path "
+     "pairs per node pair")
+    ("sw", "run the slot window search")
+
+    ("threads", po::value<unsigned>(&result.threads)->default_value(1),
+     "the number of threads of a generic Dijkstra search, of a slot "
+     "window search, and of building the path pairs")
+
+    ("warmup", po::value<int>(&result.warmup)->default_value(1),
+     "the number of warm-up runs")
+
+    ("reps", po::value<int>(&result.reps)->default_value(10),
+     "the number of measured runs");
+
+  try
+    {
+      po::variables_map vm;
+      po::store(po::command_line_parser(argc, argv).options(opts).run(),
+                vm);
+
+      if (vm.count("help"))
+        {
+          cout << opts << "\n";
+          exit(0);
+        }
+
+      po::notify(vm);
+
+      for (const char *a: {"gd", "gdb", "bf", "ee", "ksp", "sw"})
+        if (vm.count(a))
+          result.algs.push_back(a);
+
+      if (vm.count("ksp") && !result.k)
+        {
+          cerr << "The number of path pairs of --ksp should be "
+            "positive.\n";
+          exit(1);
+        }
+
+      if (result.warmup < 0)
+        {
+          cerr << "The number of warm-up runs should not be negative.\n";
+          exit(1);
+        }
+
+      if (result.reps < 1)
+        {
+          cerr << "The number of measured runs should be positive.\n";
+          exit(1);
+        }
+
+      if (result.algs.empty())
+        result.algs.push_back("gd");
+    }
+  catch(const std::exception& e)
+    {
+      cerr << e.what() << std::endl;
+      exit(1);
+    }
+
+  return result;
+}
+
+// Load the demands.  Every line has the names of the end nodes, and
+// the number of contiguous units, e.g., "v01 v07 3".
+bool
+load_demands(const string &file_name, const graph &g,
+             vector<demand> &ds)
+{
+  ifstream is(file_name);
+
+  if (!is)
+    {
+      cerr << "Error opening a demands file '" << file_name << "'.\n";
+      return false;
+    }
+
+  // The vertexes by their name.
+  map<string, vertex> vs;
+  for (vertex v: boost::make_iterator_range(vertices(g)))
+    vs[boost::get(boost::vertex_name, g, v)] = v;
+
+  for (string line; getline(is, line);)
+    {
+      if (line.empty() || line[0] == '#')
+        continue;
+
+      istringstream ls(line);
+      string src, dst;
+      int ncu;
+
+      if (!(ls >> src >> dst >> ncu) || !vs.count(src) ||
+          !vs.count(dst) || src == dst || ncu < 1)
+        {
+          cerr << "Wrong demand line: '" << line << "'.\n";
+          return false;
+        }
+
+      ds.push_back(demand(npair(vs[src], vs[dst]), ncu));
+    }
+
+  return true;
+}
+
+// The results of running an algorithm for all demands once.
+struct run_result
+{
+  // The number of labels made permanent.
+  unsigned long labels = 0;
+  // The number of demands for which a path pair was found.
+  unsigned long found = 0;
+};
+
+run_result
+run(const graph &g, dist_table &dt, const ksp_table &kt,
+    const occupancy &o, const vector<edge> &es, const string &alg,
+    unsigned beam, unsigned threads, const vector<demand> &ds)
+{
+  run_result result;
+
+  for (const auto &d: ds)
+    {
+      vertex src = d.first.first;
+      const vector<COST> *dist = &dt.to(d.first.second);
+
+      // The maximal total number of units on the src out edges, as in
+      // routing::set_up.
+      unsigned nou = 0;
+      for (const auto &e: make_iterator_range(out_edges(src, g)))
+        nou = std::max(nou, boost::get(boost::edge_nou, g, e));
+
+      CU cu(0, nou);
+      optional<cupp> p;
+
+      if (alg == "gd")
+        {
+          gd_budget b;
+          b.m_threads = threads;
+          auto r = gd(g, es, d, cu, &b, dist);
+          result.labels += r.first[4];
+          p = r.second;
+        }
+      else if (alg == "gdb")
+        {
+          gd_budget b;
+          b.m_beam = beam;
+          b.m_threads = threads;
+          auto r = gd(g, es, d, cu, &b, dist);
+          result.labels += r.first[4];
+          p = r.second;
+        }
+      else if (alg == "bf")
+        p = bf(g, es, d, cu, dist);
+      else if (alg == "ksp")
+        p = ksp(g, kt, d, cu);
+      else if (alg == "sw")
+        p = sw(g, o, es, d, cu, threads);
+      else
+        p = ee(g, d, cu);
+
+      result.found += p.has_value();
+    }
+
+  return result;
+}
+
+int
+main(int argc, const char *argv[])
+{
+  bench_args args = process_bench_args(argc, argv);
+
+  graph g;
+
+  if (!load_graphviz(args.net, g))
+    return 1;
+
+  set_units(g, args.units);
+
+  if (!args.state.empty())
+    {
+      snapshot s;
+      if (!load_snapshot(args.state, g, s))
+        return 1;
+      restore_snapshot(g, s);
+    }
+
+  vector<demand> ds;
+
+  if (!load_demands(args.demands, g, ds) || ds.empty())
+    return 1;
+
+  // Set the reach as the simulation does.
+  dbl_acc hop_acc;
+  dbl_acc len_acc;
+  calc_sp_stats(g, hop_acc, len_acc);
+  adaptive_units<COST>::set_reach_1(ba::max(len_acc) * 1.5);
+
+  // The shortest distances to the destinations, calculated in the
+  // warm-up runs.
+  dist_table dt;
+  dt.reset(g);
+
+  // The path pairs, built once, and not timed.
+  ksp_table kt;
+  if (count(args.algs.begin(), args.algs.end(), "ksp"))
+    kt.build(g, args.k, args.threads);
+
+  // The spectrum occupancy of the slot window search.
+  occupancy o;
+  o.reset(g);
+  // The edge descriptors.
+  vector<edge> es = get_edges(g);
+
+  cout << "{\n";
+  cout << "  \"net\": \"" << args.net << "\",\n";
+  cout << "  \"units\": " << args.units << ",\n";
+  cout << "  \"demands\": " << ds.size() << ",\n";
+  cout << "  \"warmup\": " << args.warmup << ",\n";
+  cout << "  \"reps\": " << args.reps << ",\n";
+  cout << "  \"threads\": " << args.threads << ",\n";
+  cout << "  \"algorithms\": {";
+
+  for (auto i = args.algs.begin(); i != args.algs.end(); ++i)
+    {
+      const string &alg = *i;
+
+      for (int r = 0; r < args.warmup; ++r)
+        run(g, dt, kt, o, es, alg, args.beam, args.threads, ds);
+
+      run_result rr;
+      unsigned long a0 = allocations;
+      auto t0 = chrono::steady_clock::now();
+
+      for (int r = 0; r < args.reps; ++r)
+        rr = run(g, dt, kt, o, es, alg, args.beam, args.threads, ds);
+
+      auto t1 = chrono::steady_clock::now();
+      unsigned long a1 = allocations;
+
+      // The number of searches timed.
+      double n = static_cast<double>(args.reps) * ds.size();
+      chrono::duration<double, nano> elapsed = t1 - t0;
+
+      cout << (i == args.algs.begin() ? "\n" : ",\n");
+      cout << "    \"" << alg << "\": {\n";
+      cout << "      \"ns_per_search\": " << elapsed.count() / n << ",\n";
+      if (alg == "gd" || alg == "gdb")
+        cout << "      \"labels_per_search\": "
+             << static_cast<double>(rr.labels) / ds.size() << ",\n";
+      cout << "      \"allocs_per_search\": " << (a1 - a0) / n << ",\n";
+      cout << "      \"found\": " << rr.found << "\n";
+      cout << "    }";
+    }
+
+  cout << "\n  }\n}\n";
+
+  return 0;
+}
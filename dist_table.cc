@@ -0,0 +1,30 @@
+#include "dist_table.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+
+using namespace std;
+
+void
+dist_table::reset(const graph &g)
+{
+  m_g = &g;
+  m_dists.assign(num_vertices(g), {});
+}
+
+const vector<COST> &
+dist_table::to(vertex dst)
+{
+  assert(m_g);
+  vector<COST> &dist = m_dists[dst];
+
+  // The graph is undirected, so the distances to dst are the
+  // distances from dst.
+  if (dist.empty())
+    {
+      dist.resize(num_vertices(*m_g));
+      boost::dijkstra_shortest_paths
+        (*m_g, dst, boost::distance_map(&dist[0]));
+    }
+
+  return dist;
+}
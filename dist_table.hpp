@@ -0,0 +1,30 @@
+#ifndef DIST_TABLE_HPP
+#define DIST_TABLE_HPP
+
+#include "graph.hpp"
+
+#include <vector>
+
+// The table of the shortest distances to the destinations.  The
+// distances to a destination are calculated with the Dijkstra
+// algorithm when they are asked for the first time, and then kept,
+// since the edge weights do not change.
+class dist_table
+{
+  // The graph.
+  const graph *m_g = nullptr;
+
+  // The distances to the destinations, empty if not calculated yet.
+  std::vector<std::vector<COST>> m_dists;
+
+public:
+  // Reset the table for the graph.
+  void
+  reset(const graph &g);
+
+  // The shortest distances from the vertexes to dst.
+  const std::vector<COST> &
+  to(vertex dst);
+};
+
+#endif // DIST_TABLE_HPP
@@ -12,11 +12,25 @@
 #include "utils.hpp"
 
 #include <optional>
-#include <set>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
+// The edge predicate of the filtered graph, which excludes the edges
+// marked in the vector indexed with the edge ID.
+struct not_excluded
+{
+  const graph *m_g = nullptr;
+  const vector<bool> *m_ex = nullptr;
+
+  bool
+  operator()(const edge &e) const
+  {
+    return !(*m_ex)[boost::get(boost::edge_index, *m_g, e)];
+  }
+};
+
 template<typename Graph>
 optional<cupath>
 search(const Graph &g, const demand &d, const CU &cu)
@@ -80,17 +94,15 @@ ee(const graph &g, const demand &d, const CU &cu)
       const auto &p1 = first.value();
 
       // Excluded edges.
-      set<edge> ee;
+      vector<bool> ee(num_edges(g));
 
       for(const auto &e: p1.second)
-        ee.insert(e);
+        ee[boost::get(boost::edge_index, g, e)] = true;
 
       // The filtered graph type.
-      using fg_type =
-        boost::filtered_graph<graph,
-                              boost::is_not_in_subset<set<edge>>>;
+      using fg_type = boost::filtered_graph<graph, not_excluded>;
 
-      fg_type fg(g, ee);
+      fg_type fg(g, not_excluded{&g, &ee});
 
       auto second = search(fg, d, cu);
 
@@ -103,9 +115,8 @@ ee(const graph &g, const demand &d, const CU &cu)
           assert(get_cost(g, p1) <= get_cost(g, p2));
 
           // Let's make sure that the two paths have no mutual edges.
-          for(const auto &e1: p1.second)
-            for(const auto &e2: p2.second)
-              assert(e1 != e2);
+          for(const auto &e2: p2.second)
+            assert(!ee[boost::get(boost::edge_index, g, e2)]);
 
           return make_pair(p1, p2);
         }
@@ -0,0 +1,84 @@
+#ifndef EID_ARENA_HPP
+#define EID_ARENA_HPP
+
+#include "graph.hpp"
+
+#include <cassert>
+#include <vector>
+
+// The arena of edge IDs.  A span of the arena, given with its offset
+// and length, holds the edge IDs of the paths of a connection.  A
+// freed span goes to the free list of its length, and is reused for a
+// span of the same length, and so once the arena has grown to the
+// peak number of spans of every length, allocating a span allocates
+// no memory.
+//
+// The spans are referred to with offsets, because the arena can move
+// when it grows.
+class eid_arena
+{
+  // The edge IDs of all spans.
+  std::vector<eid> m_ids;
+
+  // The offsets of the free spans, indexed with the length.
+  std::vector<std::vector<unsigned>> m_free;
+
+  // The number of edge IDs in the spans allocated and not freed.
+  std::size_t m_size = 0;
+
+public:
+  // Allocate a span of length n, and return its offset.
+  unsigned
+  allocate(unsigned n)
+  {
+    m_size += n;
+
+    if (n < m_free.size() && !m_free[n].empty())
+      {
+        unsigned off = m_free[n].back();
+        m_free[n].pop_back();
+        return off;
+      }
+
+    unsigned off = m_ids.size();
+    m_ids.resize(off + n);
+    return off;
+  }
+
+  // Free the span of length n at the offset.
+  void
+  free(unsigned off, unsigned n)
+  {
+    assert(off + n <= m_ids.size());
+    assert(m_size >= n);
+    m_size -= n;
+
+    if (m_free.size() <= n)
+      m_free.resize(n + 1);
+
+    m_free[n].push_back(off);
+  }
+
+  eid *
+  data(unsigned off)
+  {
+    assert(off <= m_ids.size());
+    return m_ids.data() + off;
+  }
+
+  const eid *
+  data(unsigned off) const
+  {
+    assert(off <= m_ids.size());
+    return m_ids.data() + off;
+  }
+
+  // The number of edge IDs in the spans allocated and not freed.
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+};
+
+#endif // EID_ARENA_HPP
@@ -1,14 +1,23 @@
+#include "gd.hpp"
+
 #include "adaptive_units.hpp"
 #include "graph.hpp"
 #include "label.hpp"
+#include "radix_heap.hpp"
 #include "shared.hpp"
 #include "units.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <optional>
-#include <queue>
+#include <thread>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -37,88 +46,156 @@ struct matrix
   };
 };
 
-// The permanent labels type.
-using permanent_t = matrix<std::vector<tnsp_t> >;
+// The permanent labels type: the indexes of the tree nodes, sorted
+// by cost.
+using permanent_t = matrix<std::vector<tni_t> >;
 
-// The tentative labels type.
-using tentative_t = matrix<std::set<tnsp_t> >;
+// The tentative labels type: the indexes of the tree nodes, in the
+// order of insertion.
+using tentative_t = matrix<std::vector<tni_t> >;
 
-// The priority queue element type.
-using pqe_t = std::pair<COST, std::weak_ptr<tn_t> >;
+// The priority queue type.  The priorities of the labels created
+// are not smaller than the priority of the label processed, so a
+// monotone queue will do.
+using pq_t = radix_heap<tni_t>;
 
-// The priority queue type.
-using pq_t = std::priority_queue<pqe_t, std::vector<pqe_t>,
-                                 std::function<bool(const pqe_t &,
-                                                    const pqe_t &)> >;
+// The cost of the label pair, i.e., the priority of the label pair.
+COST
+get_lp_cost(const label_pair_t &lp, int ncu)
+{
+  COST l1 = lp.first.first;
+  COST l2 = lp.second.first;
+  COST c1 = l1 * adaptive_units<COST>::units(ncu, l1);
+  COST c2 = l2 * adaptive_units<COST>::units(ncu, l2);
+  return c1 + c2;
+}
 
 bool
-has_better_or_equal(const std::vector<tnsp_t> &Svp,
+has_better_or_equal(const search_tree &tree,
+                    const std::vector<tni_t> &vp_labels,
                     const label_pair_t &j)
 {
-  for (auto const &e: Svp)
-    {
-      const label_pair_t &i = std::get<1>(*e);
-      if (i <= j)
-        return true;
-    }
+  for (tni_t i: vp_labels)
+    if (tree.better_or_equal(i, j))
+      return true;
 
   return false;
 }
 
+// Discard the tentative labels worse than or equal to label pair j,
+// and append them to discards, if given.
+void
+discard_worse(search_tree &tree, tentative_t &Q, const vertex_pair_t &vp,
+              const label_pair_t &j, unsigned long &Qc,
+              std::vector<tni_t> *discards)
+{
+  auto &Qvp = Q[vp];
+
+  auto end = std::remove_if(Qvp.begin(), Qvp.end(),
+                            [&](tni_t i)
+                            {
+                              assert(tree.lp(i) != j);
+
+                              if (!tree.worse_or_equal(i, j))
+                                return false;
+
+                              tree[i].m_discarded = true;
+                              if (discards)
+                                discards->push_back(i);
+                              --Qc;
+                              return true;
+                            });
+  Qvp.erase(end, Qvp.end());
+}
+
+// True if label pair a is worse than b for the beam: a costs more,
+// or costs the same, but has narrower CUs.
 bool
-has_better_or_equal(const std::set<tnsp_t> &Qvp,
-                    const label_pair_t &j)
+beam_worse(const label_pair_t &a, const label_pair_t &b, int ncu)
 {
-  for (auto const &e: Qvp)
-    {
-      const label_pair_t &i = std::get<1>(*e);
-      if (i <= j)
-        return true;
-    }
+  COST ac = get_lp_cost(a, ncu);
+  COST bc = get_lp_cost(b, ncu);
 
-  return false;
+  if (ac != bc)
+    return ac > bc;
+
+  return a.first.second.count() + a.second.second.count() <
+    b.first.second.count() + b.second.second.count();
 }
 
-void
-discard_worse(tentative_t &Q, const vertex_pair_t &vp,
-              const label_pair_t &j, unsigned long &Qc)
+// Make room for label pair j at a vertex pair, so that the vertex
+// pair has at most beam labels, both permanent and tentative.  The
+// worst tentative label is discarded, unless j is worse, or there are
+// only permanent labels, and then false is returned.
+bool
+make_room(search_tree &tree, const std::vector<tni_t> &Svp,
+          std::vector<tni_t> &Qvp, const label_pair_t &j, int ncu,
+          unsigned beam, unsigned long &Qc, unsigned long &pruned)
 {
-  auto &Qvp = Q[vp];
+  if (Svp.size() + Qvp.size() < beam)
+    return true;
 
-  for(auto iter = Qvp.begin(); iter != Qvp.end();)
-    {
-      const label_pair_t &i = std::get<1>(**iter);
-      auto tmp = iter;
-      ++iter;
-      
-      assert(i != j);
+  ++pruned;
 
-      if (j <= i)
-        {
-          Qvp.erase(tmp);
-          --Qc;
-        }
-    }
+  auto worst = Qvp.end();
+  for(auto iter = Qvp.begin(); iter != Qvp.end(); ++iter)
+    if (worst == Qvp.end() ||
+        beam_worse(tree.lp(*iter), tree.lp(*worst), ncu))
+      worst = iter;
 
+  if (worst == Qvp.end() || !beam_worse(tree.lp(*worst), j, ncu))
+    return false;
+
+  tree[*worst].m_discarded = true;
+  Qvp.erase(worst);
+  --Qc;
+
+  return true;
 }
 
+// The candidate label pair made by relaxing an edge.
+struct cand_t
+{
+  vertex_pair_t m_vp;
+  label_pair_t m_lp;
+  eid m_e;
+  bool m_swapped;
+};
+
+// Make the candidate label pairs for the label pair of tree node tni
+// relaxed along edge e, and append them to cs.  The candidates that
+// would use an edge already used are not made.  If prefilter, the
+// candidates dominated by the labels of S or Q are not made either.
+// The function only reads S, Q, and the tree, and so it can run
+// concurrently with itself.
 void
-relax(const graph &g, const permanent_t &S, tentative_t &Q,
-      const edge &e, const vertex const_v, const label &const_l,
-      const label &other_l, const tnsp_t &tnsp, pq_t &pq,
-      const int &ncu, unsigned long &Qc)
+make_candidates(const graph &g, const permanent_t &S,
+                const tentative_t &Q, const search_tree &tree,
+                const edge &e, const vertex const_v,
+                const label &const_l, const label &other_l, tni_t tni,
+                const int &ncu, const std::vector<COST> *dist,
+                bool prefilter, std::vector<cand_t> &cs)
 {
   // The new vertex - target of edge e.
   vertex nv = target(e, g);
+  // The edge ID.
+  eid ei = boost::get(boost::edge_index, g, e);
+
+  // Make sure that e has not been already used.
+  if (tree.uses(tni, ei))
+    return;
+
   // The edge cost.
   auto ec = boost::get(boost::edge_weight, g, e);
   // The edge SU.
   const SU &e_su = boost::get(boost::edge_su, g, e);
   // The new cost.
   auto nc = other_l.first + ec;
+  // The lower bound on the length of the path completed at dst.
+  COST lb = dist ? nc + (*dist)[nv] : nc;
   // The new candidate SU.
   SU n_su = intersection(SU{other_l.second}, e_su);
-  n_su.remove(adaptive_units<COST>::units(ncu, nc));
+  n_su.remove(adaptive_units<COST>::units(ncu, lb));
 
   // Iterate over new candidate CUs.
   for(const auto &n_cu: n_su)
@@ -141,35 +218,143 @@ relax(const graph &g, const permanent_t &S, tentative_t &Q,
           swapped = true;
         }
 
-      if (has_better_or_equal(S[cvp], clp) ||
-          has_better_or_equal(Q[cvp], clp))
+      if (prefilter && (has_better_or_equal(tree, S[cvp], clp) ||
+                        has_better_or_equal(tree, Q[cvp], clp)))
         continue;
 
-      // Make sure that e has not been already used.
-      const tn_t *ptr = tnsp.get();
-      for(; ptr != nullptr; ptr = std::get<4>(*ptr).get())
-        if (std::get<2>(*ptr) == e)
-          break;
+      cs.push_back({cvp, clp, ei, swapped});
+    }
+}
+
+// Add the candidate made for tree node tni, unless it's dominated.
+// The labels discarded are appended to discards, if given.
+void
+add_candidate(const permanent_t &S, tentative_t &Q, search_tree &tree,
+              const cand_t &c, tni_t tni, pq_t &pq, const int &ncu,
+              unsigned long &Qc, unsigned beam, unsigned long &pruned,
+              std::vector<tni_t> *discards)
+{
+  const vertex_pair_t &cvp = c.m_vp;
+  const label_pair_t &clp = c.m_lp;
+
+  if (has_better_or_equal(tree, S[cvp], clp) ||
+      has_better_or_equal(tree, Q[cvp], clp))
+    return;
+
+  discard_worse(tree, Q, cvp, clp, Qc, discards);
 
-      // Edge e is not used when we reached the tree root.
-      if (ptr == nullptr)
+  if (beam && !make_room(tree, S[cvp], Q[cvp], clp, ncu, beam, Qc,
+                         pruned))
+    return;
+
+  tni_t n = tree.add(cvp, clp, c.m_e, c.m_swapped, tni);
+  Q[cvp].push_back(n);
+  ++Qc;
+  pq.push(to_radix_key(get_lp_cost(clp, ncu)), n);
+}
+
+// Make the candidates for tree node tni, i.e., relax the edges
+// leaving both vertexes of its vertex pair, except dst.
+void
+expand(const graph &g, const permanent_t &S, const tentative_t &Q,
+       const search_tree &tree, tni_t tni, vertex dst, const int &ncu,
+       const std::vector<COST> *dist, bool prefilter,
+       std::vector<cand_t> &cs)
+{
+  // Vertexes.
+  const auto [v1, v2] = tree.vp(tni);
+  // Labels.
+  const auto [l1, l2] = tree.lp(tni);
+
+  // We are leaving vertex v1.
+  if (v1 != dst)
+    for(const auto &e: make_iterator_range(out_edges(v1, g)))
+      make_candidates(g, S, Q, tree, e, v2, l2, l1, tni, ncu, dist,
+                      prefilter, cs);
+
+  // We are leaving vertex v2.
+  if (v2 != dst)
+    for(const auto &e: make_iterator_range(out_edges(v2, g)))
+      make_candidates(g, S, Q, tree, e, v1, l1, l2, tni, ncu, dist,
+                      prefilter, cs);
+}
+
+// Rewind the search of the state to before step m_keep: truncate the
+// tree and the logs, and restore the labels and the queue as they
+// were then.  The queue holds the discarded labels not popped yet too,
+// and pops in the order that depends on its entries only.
+void
+rewind(gd_state &s, permanent_t &S, tentative_t &Q, pq_t &pq,
+       unsigned long &Sc, unsigned long &Qc, int ncu)
+{
+  std::size_t k = s.m_keep;
+  search_tree &tree = s.m_tree;
+
+  // The number of tree nodes made before step k.
+  tni_t n = k ? s.m_steps[k - 1].m_nodes : 1;
+  tree.truncate(n);
+  s.m_reads.resize(k ? s.m_steps[k - 1].m_reads : 0);
+
+  // Undo the discards of the steps from k on.
+  std::size_t nd = k ? s.m_steps[k - 1].m_discards : 0;
+  for (std::size_t i = nd; i < s.m_discards.size(); ++i)
+    if (s.m_discards[i] < n)
+      tree[s.m_discards[i]].m_discarded = false;
+  s.m_discards.resize(nd);
+
+  // The labels popped before step k, and made permanent unless
+  // discarded.
+  std::vector<bool> popped(n);
+  for (std::size_t j = 0; j < k; ++j)
+    {
+      tni_t i = s.m_steps[j].m_tni;
+      popped[i] = true;
+      if (!tree[i].m_discarded)
         {
-          discard_worse(Q, cvp, clp, Qc);
-          auto sp = make_shared<tn_t>(cvp, clp, e, swapped, tnsp);
-          Q[cvp].insert(sp);
-          ++Qc;
-          COST l1 = clp.first.first;
-          COST l2 = clp.second.first;
-          COST c1 = l1 * adaptive_units<COST>::units(ncu, l1);
-          COST c2 = l2 * adaptive_units<COST>::units(ncu, l2);
-          pq.push({c1 + c2, sp});
+          S[tree.vp(i)].push_back(i);
+          ++Sc;
         }
     }
+
+  // The tentative labels are kept in the order of insertion.  The
+  // search does not count the boot label as tentative.
+  --Qc;
+  for (tni_t i = 0; i < n; ++i)
+    if (!popped[i])
+      {
+        pq.push(to_radix_key(get_lp_cost(tree.lp(i), ncu)), i);
+        if (!tree[i].m_discarded)
+          {
+            Q[tree.vp(i)].push_back(i);
+            ++Qc;
+          }
+      }
+
+  s.m_steps.resize(k);
+}
+
+// The bucket width for the parallel search: half the min edge weight.
+// Relaxing a label increases its priority by at least the weight of
+// the edge, and so the labels created from the labels of a bucket
+// fall into later buckets.  The half is the margin for rounding.
+COST
+get_delta(const graph &g)
+{
+  COST w = std::numeric_limits<COST>::max();
+  for (const auto &e: make_iterator_range(edges(g)))
+    w = std::min(w, boost::get(boost::edge_weight, g, e));
+
+  return num_edges(g) ? w / 2 : 0;
 }
 
-pair<array<unsigned long, 4>,
+// The min number of labels in a bucket to expand them in parallel.
+constexpr std::size_t min_parallel = 256;
+
+pair<array<unsigned long, 5>,
      std::optional<std::pair<cupath, cupath>>>
-gd(const graph &g, const demand &d, const CU &cu)
+gd(const graph &g, const std::vector<edge> &es, const demand &d,
+   const CU &cu, gd_budget *budget, const std::vector<COST> *dist,
+   std::vector<eid> *reads, gd_state *state)
 {
   std::optional<std::pair<cupath, cupath> > result;
 
@@ -185,17 +370,11 @@ gd(const graph &g, const demand &d, const CU &cu)
   tentative_t Q(num_vertices(g));
 
   // The priority queue.
-  pq_t pq([](const pqe_t &a, const pqe_t &b)
-          {return !(a.first < b.first);});
-
-  // The boot label.
-  auto blsp = std::make_shared<tn_t>(pair(src, src),
-                                     pair(label(0, cu), label(0, cu)),
-                                     edge(), false, nullptr);
+  pq_t pq;
 
-  // Boot the search with the root of the search tree.
-  pq.push({0, blsp});
-  Q[pair(src, src)].insert(blsp);
+  // The search tree, kept in the state, if given.
+  search_tree own_tree;
+  search_tree &tree = state ? state->m_tree : own_tree;
 
   // Count of permanent labels.
   unsigned long Sc = 0;
@@ -211,85 +390,268 @@ gd(const graph &g, const demand &d, const CU &cu)
   // The max tentative labels count, when mmwu was max.
   unsigned long mqc = 0;
 
-  while(!pq.empty())
-    {
-      // The number of priority queue memory words.  Each queue
-      // element has the cost of 8 bytes (one 64-bit word), and a weak
-      // pointer of 8 bytes (one 64-bit word).  We account for the
-      // memory taken by the management structure of the weak pointer
-      // when we account for the memory taken by the shared pointers
-      // of the tentative labels.
-      unsigned long pqmw = 2 * pq.size();
-      // For each permanent label we need:
-      // * 4 words (a most, usually 2 words) for a shared pointer, so
-      //   so that the label is stored in a vector,
-      // * 1 word for a vertex pair,
-      // * 4 words for a label pair (2 * 2: 1 for COST, 1 for CU),
-      // * 2 words for an edge,
-      // * 4 words for a shared pointer to the parent tree node.
-      unsigned long Smw = 15 * Sc;
-      // For each tentative label we need the same number of words as
-      // for a permanent label.
-      unsigned long Qmw = 15 * Qc;
-      // Memory words used.
-      unsigned mwu = pqmw + Smw + Qmw;
-      
-      if (mmwu < mwu)
-        {
-          mmwu = mwu;
-          mpqc = pq.size();
-          msc = Sc;
-          mqc = Qc;
-        }
+  // The labels discarded, logged for the state.
+  std::vector<tni_t> *discards = nullptr;
 
-      // Here we get a copy of a shared_ptr.
-      auto pqe = pq.top();
-      pq.pop();
-      auto tnsp = pqe.second.lock();
+  if (state)
+    {
+      assert(!reads);
+      assert(!budget || (!budget->m_labels && !(budget->m_time > 0) &&
+                         !budget->m_beam));
 
-      // We don't care about a removed label.
-      if (tnsp == nullptr)
-        continue;
+      reads = &state->m_reads;
+      discards = &state->m_discards;
 
-      const tn_t &tn = *tnsp;
+      if (state->m_valid && state->m_d == d && state->m_cu == cu)
+        {
+          // Nothing the search read has changed.
+          if (state->m_keep == state->m_steps.size())
+            return state->m_p;
+
+          rewind(*state, S, Q, pq, Sc, Qc, ncu);
+
+          if (state->m_keep)
+            {
+              const auto &m = state->m_steps.back().m_mem;
+              mmwu = m[0];
+              mpqc = m[1];
+              msc = m[2];
+              mqc = m[3];
+            }
+        }
+      else
+        {
+          state->m_d = d;
+          state->m_cu = cu;
+          tree.truncate(0);
+          state->m_steps.clear();
+          state->m_reads.clear();
+          state->m_discards.clear();
+        }
 
-      // The vertex pair of the tree node.
-      const vertex_pair_t &vp = std::get<0>(tn);
+      state->m_valid = false;
+      state->m_keep = 0;
+    }
 
-      // We remove the shared_ptr from the tentative set.
-      auto num = Q[vp].erase(tnsp);
-      assert(num == 1);
-      // We push_back to have the labels sorted according to cost.
-      S[vp].push_back(tnsp);
+  // Boot the search with the root of the search tree, unless resumed.
+  if (!tree.size())
+    {
+      // The boot label.
+      tni_t bl = tree.add(pair(src, src), pair(label(0, cu), label(0, cu)),
+                          no_eid, false, no_tni);
 
-      // Modify the counts.
-      --Qc;
-      ++Sc;
+      pq.push(to_radix_key(0), bl);
+      Q[pair(src, src)].push_back(bl);
+    }
 
-      // Vertexes.
-      const auto & [v1, v2] = vp;
-      assert(v1 <= v2);
+  // The max number of labels per vertex pair, 0 for no limit.
+  unsigned beam = budget ? budget->m_beam : 0;
+  // The number of labels pruned because of the beam.
+  unsigned long pruned = 0;
+
+  // The search deadline, if the time budget is given.
+  using clock = chrono::steady_clock;
+  std::optional<clock::time_point> deadline;
+  if (budget && budget->m_time > 0)
+    deadline = clock::now() +
+      chrono::duration_cast<clock::duration>
+      (chrono::duration<double>(budget->m_time));
+
+  // The number of threads.
+  unsigned threads = budget ? std::max(1u, budget->m_threads) : 1;
+  // The bucket width.  With one thread, a bucket is a single label.
+  COST delta = threads > 1 ? get_delta(g) : 0;
+
+  // The labels of the current bucket with their keys, popped in the
+  // order of the sequential search.
+  std::vector<std::pair<std::uint64_t, tni_t> > bucket;
+  // The candidates of the labels of the bucket, when made in
+  // parallel.
+  std::vector<std::vector<cand_t> > cands;
+  // The candidates of a label, when made sequentially.
+  std::vector<cand_t> cs;
+
+  for (bool stop = false; !stop && !pq.empty();)
+    {
+      // Pop the labels of the priority less than the priority of the
+      // first label plus delta.  No label of the bucket can be
+      // created or dominated by the labels created from the bucket,
+      // and so the labels of the bucket are processed in the order
+      // and with the results of the sequential search.  The queue is
+      // peeked at, because the labels created can cost less than the
+      // first label past the bucket.
+      bucket.clear();
+      std::uint64_t bound =
+        to_radix_key(from_radix_key(pq.top_key()) + delta);
+      do
+        {
+          bucket.emplace_back(pq.top_key(), pq.top_value());
+          pq.pop();
+        }
+      while (delta > 0 && !pq.empty() && pq.peek_key() < bound);
+
+      // Make the candidates of the bucket in parallel.  The dominance
+      // prefilter is exact, because a dominating label stays or is
+      // discarded by a label that dominates it in turn, but not with
+      // the beam, which discards labels regardless.
+      bool parallel = bucket.size() >= min_parallel;
+      if (parallel)
+        {
+          cands.resize(bucket.size());
+          std::atomic<std::size_t> next(0);
+          auto worker = [&]()
+                        {
+                          for (std::size_t j;
+                               (j = next++) < bucket.size();)
+                            {
+                              tni_t i = bucket[j].second;
+                              cands[j].clear();
+                              if (!tree[i].m_discarded)
+                                expand(g, S, Q, tree, i, dst, ncu, dist,
+                                       !beam, cands[j]);
+                            }
+                        };
+
+          std::vector<std::thread> ts;
+          for (unsigned t = 1; t < threads; ++t)
+            ts.emplace_back(worker);
+          worker();
+          for (auto &t: ts)
+            t.join();
+        }
 
-      if (v1 == dst && v2 == dst)
+      for (std::size_t j = 0; j < bucket.size(); ++j)
         {
-          result = trace(g, tn, ncu);
-          break;
+          // The labels of the bucket not processed yet would still be
+          // in the queue of the sequential search.
+          unsigned long pqs = pq.size() + bucket.size() - j;
+
+          // The number of priority queue memory words.  Each queue
+          // element has the key of 8 bytes (one 64-bit word), and the
+          // index of the tree node of 4 bytes, padded to a word.
+          unsigned long pqmw = 2 * pqs;
+          // For each permanent label we need:
+          // * 3.5 words for a tree node,
+          // * 2 words for the costs of the label pair,
+          // * 0.5 word for the index in S.
+          unsigned long Smw = 6 * Sc;
+          // For each tentative label we need the same number of words
+          // as for a permanent label.
+          unsigned long Qmw = 6 * Qc;
+          // Memory words used.
+          unsigned mwu = pqmw + Smw + Qmw;
+
+          if (mmwu < mwu)
+            {
+              mmwu = mwu;
+              mpqc = pqs;
+              msc = Sc;
+              mqc = Qc;
+            }
+
+          // Check the budget.  The clock is read every 64 labels only.
+          if (budget && ((budget->m_labels && Sc >= budget->m_labels) ||
+                         (deadline && !(Sc & 63) &&
+                          clock::now() >= deadline.value())))
+            {
+              budget->m_hit = true;
+              // The labels not made permanent yet cost at least as
+              // much as the label at the top of the queue.
+              budget->m_lb = from_radix_key(bucket[j].first);
+
+              // The best complete path pair found so far.
+              std::optional<tni_t> best;
+              for (tni_t i: Q[pair(dst, dst)])
+                if (!best || get_lp_cost(tree.lp(i), ncu) <
+                    get_lp_cost(tree.lp(best.value()), ncu))
+                  best = i;
+
+              if (best)
+                result = trace(g, es, tree, best.value(), ncu);
+
+              stop = true;
+              break;
+            }
+
+          tni_t tni = bucket[j].second;
+
+          // Log the step.  The step ends where it begins, unless the
+          // label is expanded.
+          if (state)
+            state->m_steps.push_back({tni, tni_t(tree.size()),
+                                      std::uint32_t(reads->size()),
+                                      std::uint32_t(discards->size()),
+                                      {mmwu, mpqc, msc, mqc}});
+
+          // We don't care about a discarded label.
+          if (tree[tni].m_discarded)
+            continue;
+
+          // The vertex pair of the tree node.
+          const vertex_pair_t vp = tree.vp(tni);
+
+          // We remove the label from the tentative set.
+          auto &Qvp = Q[vp];
+          auto qi = std::find(Qvp.begin(), Qvp.end(), tni);
+          assert(qi != Qvp.end());
+          Qvp.erase(qi);
+          // We push_back to have the labels sorted according to cost.
+          S[vp].push_back(tni);
+
+          // Modify the counts.
+          --Qc;
+          ++Sc;
+
+          // Vertexes.
+          const auto & [v1, v2] = vp;
+          assert(v1 <= v2);
+
+          if (v1 == dst && v2 == dst)
+            {
+              result = trace(g, es, tree, tni, ncu);
+              stop = true;
+              break;
+            }
+
+          if (reads)
+            for (vertex v: {v1, v2})
+              if (v != dst)
+                for(const auto &e: make_iterator_range(out_edges(v, g)))
+                  reads->push_back(boost::get(boost::edge_index, g, e));
+
+          // The candidates are made and added one label at a time, as
+          // in the sequential search, unless made in parallel.
+          if (!parallel)
+            {
+              cs.clear();
+              expand(g, S, Q, tree, tni, dst, ncu, dist, false, cs);
+            }
+
+          for (const auto &c: parallel ? cands[j] : cs)
+            add_candidate(S, Q, tree, c, tni, pq, ncu, Qc, beam, pruned,
+                          discards);
+
+          if (state)
+            {
+              auto &s = state->m_steps.back();
+              s.m_nodes = tree.size();
+              s.m_reads = reads->size();
+              s.m_discards = discards->size();
+            }
         }
+    }
 
-      // Labels.
-      const auto & [l1, l2] = std::get<1>(tn);
+  if (budget)
+    budget->m_pruned = pruned;
 
-      // We are leaving vertex v1.
-      if (v1 != dst)
-        for(const auto &e: make_iterator_range(out_edges(v1, g)))
-          relax(g, S, Q, e, v2, l2, l1, tnsp, pq, ncu, Qc);
+  auto p = make_pair(array<unsigned long, 5>{mmwu, mpqc, msc, mqc, Sc},
+                     result);
 
-      // We are leaving vertex v2.
-      if (v2 != dst)
-        for(const auto &e: make_iterator_range(out_edges(v2, g)))
-          relax(g, S, Q, e, v1, l1, l2, tnsp, pq, ncu, Qc);
+  if (state)
+    {
+      state->m_p = p;
+      state->m_valid = true;
     }
 
-  return make_pair(array<unsigned long, 4>{mmwu, mpqc, msc, mqc},
-                   result);
+  return p;
 }
@@ -2,14 +2,143 @@
 #define GD_HPP
 
 #include "graph.hpp"
+#include "shared.hpp"
 #include "units.hpp"
 
 #include <array>
+#include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
-std::pair<std::array<unsigned long, 4>,
+// The budget of the generic Dijkstra search.  The search stops when
+// it made the given number of labels permanent, or when it ran for
+// the given time.  Then the result returned is the best complete path
+// pair found so far, if any, which need not be optimal.
+//
+// The beam is the max number of labels kept at a vertex pair.  When
+// the beam is full, the worst tentative label is discarded, i.e., the
+// one of the highest cost, and of the narrowest CUs for the same
+// cost.  With the beam, the result need not be optimal either.
+struct gd_budget
+{
+  // The max number of labels made permanent, 0 for no limit.
+  unsigned long m_labels = 0;
+
+  // The max search time in seconds, 0 for no limit.
+  double m_time = 0;
+
+  // The beam, 0 for no limit.
+  unsigned m_beam = 0;
+
+  // The number of threads to expand the labels with.  With more than
+  // one thread, the labels of the priorities within half the min edge
+  // weight are expanded in parallel, and then added in the order of
+  // the sequential search, and so the result is the same.  This is
+  // not a budget, but an option of the search.
+  unsigned m_threads = 1;
+
+  // Set by the search: true if the budget was exceeded.
+  bool m_hit = false;
+
+  // Set by the search if the budget was exceeded: the lower bound on
+  // the cost of the optimal path pair.
+  COST m_lb = 0;
+
+  // Set by the search: the number of labels pruned by the beam.
+  unsigned long m_pruned = 0;
+};
+
+// The state of a generic Dijkstra search kept for the next search of
+// the same demand and CU: the search tree, and the log of the steps.
+// A step pops a label from the priority queue, and expands it.
+//
+// The steps up to the first step that read an edge whose SU changed
+// in the meantime would run the same, and so the next search rewinds
+// the state to that step, and resumes from there.  The search is the
+// same as the search anew, and so is its result.
+struct gd_state
+{
+  // A step of the search.
+  struct step_t
+  {
+    // The tree node popped.
+    tni_t m_tni;
+    // The number of tree nodes after the step.
+    tni_t m_nodes;
+    // The end of the edges read by the step in m_reads.
+    std::uint32_t m_reads;
+    // The end of the nodes discarded by the step in m_discards.
+    std::uint32_t m_discards;
+    // The max memory words used, and the priority queue, permanent
+    // and tentative label counts then, as of the step.
+    std::array<unsigned long, 4> m_mem;
+  };
+
+  // True if the state is of a finished search.
+  bool m_valid = false;
+  // The demand and the CU of the search.
+  demand m_d;
+  CU m_cu;
+
+  // The search tree.
+  search_tree m_tree;
+  // The steps.
+  std::vector<step_t> m_steps;
+  // The edges whose SUs the steps read.
+  std::vector<eid> m_reads;
+  // The nodes discarded by the steps.
+  std::vector<tni_t> m_discards;
+
+  // What the search returned.
+  std::pair<std::array<unsigned long, 5>,
+            std::optional<std::pair<cupath, cupath>>> m_p;
+
+  // The number of the steps to keep, set by invalidate.
+  std::size_t m_keep = 0;
+
+  // The time of the state for the user.
+  unsigned long m_clock = 0;
+
+  // Keep the steps before the first step that read an edge for which
+  // the changed predicate is true.
+  template <typename P>
+  void
+  invalidate(P changed)
+  {
+    std::size_t r = 0;
+    for (m_keep = 0; m_keep < m_steps.size(); ++m_keep)
+      for (; r < m_steps[m_keep].m_reads; ++r)
+        if (changed(m_reads[r]))
+          return;
+  }
+};
+
+// The generic Dijkstra search for a pair of disjoint paths.  Along
+// with the result, it returns the max memory words used, and the
+// priority queue, permanent and tentative label counts when the
+// memory used was max, and the number of labels made permanent.  The
+// search is exact, unless the budget is given and exceeded.
+//
+// The edge descriptors es are indexed with the edge ID.
+//
+// If dist, the shortest distances to dst, is given, a label is
+// pruned of the CUs too narrow for a path of the label cost plus the
+// distance to dst, which also prunes the labels beyond the reach.
+// The search remains exact.
+//
+// If reads is given, the indexes of the edges whose SUs the search
+// read are appended to it, possibly with repetitions.  The search
+// would run the same, if these SUs were the same.
+//
+// If state is given, the search resumes the search of the state, if
+// the state is of the same demand and CU, and then keeps its state
+// there.  The budget can have no limits then.
+std::pair<std::array<unsigned long, 5>,
           std::optional<std::pair<cupath, cupath>>>
-gd(const graph &g, const demand &d, const CU &cu);
+gd(const graph &g, const std::vector<edge> &es, const demand &d,
+   const CU &cu, gd_budget *budget = nullptr,
+   const std::vector<COST> *dist = nullptr,
+   std::vector<eid> *reads = nullptr, gd_state *state = nullptr);
 
 #endif // GD_HPP
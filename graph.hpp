@@ -32,7 +32,8 @@ typedef double COST;
 
 /**
  * The type of the graph we use.  The edge_su_t property describes the
- * units available, and not already taken.
+ * units available, and not already taken.  The edge_index_t property
+ * is the dense index of an edge, assigned when the graph is loaded.
  */
 typedef
 boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
@@ -40,12 +41,18 @@ boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
                                       std::string>,
                       boost::property<boost::edge_weight_t, COST,
                       boost::property<boost::edge_nou_t, unsigned,
-                      boost::property<boost::edge_su_t, SU> > > >
+                      boost::property<boost::edge_su_t, SU,
+                      boost::property<boost::edge_index_t, unsigned> > > > >
 graph;
 
 typedef graph::edge_descriptor edge;
 typedef graph::vertex_descriptor vertex;
 
+// The edge ID: the value of the edge_index property, from 0 to the
+// number of edges - 1.  The routing core refers to edges with IDs,
+// and the descriptors are looked up for the paths it returns.
+typedef unsigned eid;
+
 // The path.
 typedef std::list<edge> path;
 
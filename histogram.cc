@@ -0,0 +1,78 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void
+histogram::operator()(unsigned long v)
+{
+  unsigned b = bucket(v);
+
+  if (m_counts.size() <= b)
+    m_counts.resize(b + 1);
+
+  ++m_counts[b];
+  ++m_count;
+  m_max = std::max(m_max, v);
+}
+
+unsigned long
+histogram::count() const
+{
+  return m_count;
+}
+
+unsigned long
+histogram::max() const
+{
+  return m_max;
+}
+
+unsigned long
+histogram::quantile(double q) const
+{
+  assert(0 <= q && q <= 1);
+
+  if (!m_count)
+    return 0;
+
+  // The rank of the value we look for, counted from 1.
+  unsigned long rank = std::max(1.0, std::ceil(q * m_count));
+
+  unsigned long n = 0;
+  for (unsigned b = 0; b < m_counts.size(); ++b)
+    if ((n += m_counts[b]) >= rank)
+      return std::min(highest(b), m_max);
+
+  return m_max;
+}
+
+unsigned
+histogram::bucket(unsigned long v)
+{
+  if (v < m_S)
+    return v;
+
+  // The index of the highest bit set.
+  unsigned h = 63 - __builtin_clzl(v);
+  // The group of buckets, counted from 1.
+  unsigned g = h - m_sb + 1;
+  // The top m_sb bits of v, the highest of them set.
+  unsigned long top = v >> g;
+  assert(m_S / 2 <= top && top < m_S);
+
+  return m_S + (g - 1) * (m_S / 2) + (top - m_S / 2);
+}
+
+unsigned long
+histogram::highest(unsigned b)
+{
+  if (b < m_S)
+    return b;
+
+  unsigned g = (b - m_S) / (m_S / 2) + 1;
+  unsigned long top = (b - m_S) % (m_S / 2) + m_S / 2;
+
+  return ((top + 1) << g) - 1;
+}
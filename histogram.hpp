@@ -0,0 +1,59 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <vector>
+
+// The histogram of non-negative integer values with log-linear
+// buckets, as in the HDR histogram.  The values below 2^m_sb have
+// their own buckets, and every next power of two is split into
+// 2^(m_sb - 1) buckets of equal width, so the relative error of a
+// reported value is below 2^(1 - m_sb), i.e., about 3%.  The buckets
+// are allocated as the values grow.
+class histogram
+{
+  // The number of sub-bucket bits.
+  static constexpr unsigned m_sb = 6;
+
+  // The number of values below which values have their own buckets.
+  static constexpr unsigned long m_S = 1ul << m_sb;
+
+  // The counts of the buckets.
+  std::vector<unsigned long> m_counts;
+
+  // The number of values recorded.
+  unsigned long m_count = 0;
+
+  // The maximal value recorded.
+  unsigned long m_max = 0;
+
+public:
+  // Record the value.
+  void
+  operator()(unsigned long v);
+
+  // The number of values recorded.
+  unsigned long
+  count() const;
+
+  // The maximal value recorded.
+  unsigned long
+  max() const;
+
+  // The value below or at which the fraction q of the values lie.
+  // The value reported is the highest value of the bucket, but not
+  // greater than the maximal value recorded.  If there are no values,
+  // 0 is returned.
+  unsigned long
+  quantile(double q) const;
+
+private:
+  // The bucket of the value.
+  static unsigned
+  bucket(unsigned long v);
+
+  // The highest value of the bucket.
+  static unsigned long
+  highest(unsigned b);
+};
+
+#endif // HISTOGRAM_HPP
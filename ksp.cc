@@ -0,0 +1,472 @@
+#include "ksp.hpp"
+
+#include "adaptive_units.hpp"
+#include "utils.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+#include <thread>
+#include <tuple>
+
+using namespace std;
+
+// The other end of edge e than vertex v.
+static vertex
+other(const graph &g, const edge &e, vertex v)
+{
+  vertex s = source(e, g);
+  return s == v ? target(e, g) : s;
+}
+
+// The length of the path of the edge IDs, summed in the path order.
+static COST
+length(const graph &g, const vector<edge> &es, const vector<eid> &p)
+{
+  COST l = 0;
+  for (eid i: p)
+    l += boost::get(boost::edge_weight, g, es[i]);
+
+  return l;
+}
+
+// The Dijkstra search from s to t.  Function c gives the cost of going
+// along edge e from vertex u, or a negative cost if the edge cannot
+// be used that way.  The shortest distances from s are put into dist,
+// and they are final for all vertexes, unless stop, and then the
+// search stops at t.  The edge IDs of the path found to t are
+// returned in the order from s to t.
+template <typename C>
+static optional<vector<eid>>
+dijkstra(const graph &g, vertex s, vertex t, C c, vector<COST> &dist,
+         bool stop)
+{
+  auto n = num_vertices(g);
+  dist.assign(n, numeric_limits<COST>::infinity());
+  // The edge ID and the vertex which a vertex was reached with.
+  vector<pair<eid, vertex>> pred(n);
+  vector<bool> done(n);
+
+  // The queue of the vertexes, ordered by distance, and then by the
+  // vertex, so that the ties are broken the same way.
+  using qe_t = pair<COST, vertex>;
+  priority_queue<qe_t, vector<qe_t>, greater<qe_t>> q;
+
+  dist[s] = 0;
+  q.emplace(0, s);
+
+  while(!q.empty())
+    {
+      auto [du, u] = q.top();
+      q.pop();
+
+      if (done[u])
+        continue;
+      done[u] = true;
+
+      if (stop && u == t)
+        break;
+
+      for(const auto &e: make_iterator_range(out_edges(u, g)))
+        {
+          COST w = c(e, u);
+          vertex v = target(e, g);
+
+          if (w < 0 || done[v] || !(du + w < dist[v]))
+            continue;
+
+          dist[v] = du + w;
+          pred[v] = {boost::get(boost::edge_index, g, e), u};
+          q.emplace(dist[v], v);
+        }
+    }
+
+  if (!done[t])
+    return {};
+
+  vector<eid> p;
+  for (vertex v = t; v != s; v = pred[v].second)
+    p.push_back(pred[v].first);
+  reverse(p.begin(), p.end());
+
+  return p;
+}
+
+optional<pair<vector<eid>, vector<eid>>>
+suurballe(const graph &g, const vector<edge> &es, vertex s, vertex t,
+          const vector<bool> *usable)
+{
+  assert(s != t);
+
+  const auto null = graph::null_vertex();
+
+  // The weight of an edge, or -1 if the edge is not usable.
+  auto w = [&g, usable](const edge &e, vertex) -> COST
+           {
+             if (usable && !(*usable)[boost::get(boost::edge_index, g, e)])
+               return -1;
+
+             return boost::get(boost::edge_weight, g, e);
+           };
+
+  // The shortest distances from s, and the shortest path p1.
+  vector<COST> d;
+  auto p1 = dijkstra(g, s, t, w, d, false);
+  if (!p1)
+    return {};
+
+  // The vertex which p1 leaves an edge from, indexed with the edge
+  // ID, or null for the edges not on p1.
+  vector<vertex> from(es.size(), null);
+  for (vertex v = s; eid i: p1.value())
+    {
+      from[i] = v;
+      v = other(g, es[i], v);
+    }
+
+  // The costs reduced with the distances from s, which are not
+  // negative.  An edge of p1 can be used in reverse only, at the cost
+  // of minus its weight, which is reduced to 0.
+  auto rc = [&](const edge &e, vertex u) -> COST
+            {
+              eid i = boost::get(boost::edge_index, g, e);
+              vertex v = target(e, g);
+
+              if (from[i] == u || d[v] == numeric_limits<COST>::infinity())
+                return -1;
+
+              if (from[i] != null)
+                return 0;
+
+              COST c = w(e, u);
+              return c < 0 ? c : max(0.0, c + d[u] - d[v]);
+            };
+
+  vector<COST> d2;
+  auto p2 = dijkstra(g, s, t, rc, d2, true);
+  if (!p2)
+    return {};
+
+  // The edges of p2, which cancel the edges of p1 used in reverse.
+  vector<bool> on_p2(es.size());
+  for (eid i: p2.value())
+    on_p2[i] = true;
+
+  // The arcs left, which make up two edge-disjoint paths: the edge ID
+  // and the vertex an arc leads to, indexed with the vertex the arc
+  // leaves.
+  vector<vector<pair<eid, vertex>>> out(num_vertices(g));
+  for (vertex v = s; eid i: p1.value())
+    {
+      vertex w = other(g, es[i], v);
+      if (!on_p2[i])
+        out[v].emplace_back(i, w);
+      v = w;
+    }
+  for (vertex v = s; eid i: p2.value())
+    {
+      vertex w = other(g, es[i], v);
+      if (from[i] == null)
+        out[v].emplace_back(i, w);
+      v = w;
+    }
+
+  // Follow the arcs from s to t twice.
+  vector<eid> r[2];
+  for (auto &p: r)
+    for (vertex v = s; v != t;)
+      {
+        assert(!out[v].empty());
+        auto [i, w] = out[v].back();
+        out[v].pop_back();
+        p.push_back(i);
+        v = w;
+      }
+
+  if (make_pair(length(g, es, r[1]), r[1]) <
+      make_pair(length(g, es, r[0]), r[0]))
+    swap(r[0], r[1]);
+
+  return make_pair(std::move(r[0]), std::move(r[1]));
+}
+
+vector<vector<eid>>
+yen(const graph &g, const vector<edge> &es, vertex s, vertex t, unsigned k)
+{
+  // The paths found.
+  vector<vector<eid>> A;
+
+  // The candidate paths with their lengths, shortest first, and then
+  // in the order of the edge IDs.
+  set<pair<COST, vector<eid>>> B;
+
+  vector<COST> dist;
+  // The excluded edges and vertexes.
+  vector<bool> xe(es.size());
+  vector<bool> xv(num_vertices(g));
+
+  auto c = [&](const edge &e, vertex) -> COST
+           {
+             if (xe[boost::get(boost::edge_index, g, e)] ||
+                 xv[target(e, g)])
+               return -1;
+
+             return boost::get(boost::edge_weight, g, e);
+           };
+
+  if (!k)
+    return A;
+
+  if (auto p = dijkstra(g, s, t, c, dist, true))
+    A.push_back(std::move(p.value()));
+
+  while(!A.empty() && A.size() < k)
+    {
+      // The previous path, copied, because A grows.
+      const vector<eid> prev = A.back();
+
+      // Deviate from the previous path at its every vertex, called
+      // the spur vertex, after the root path that leads to it.
+      for (auto [i, v] = pair(size_t(0), s); i < prev.size(); ++i)
+        {
+          fill(xe.begin(), xe.end(), false);
+          fill(xv.begin(), xv.end(), false);
+
+          // Exclude the edges that the paths found with the same root
+          // path take next.
+          for (const auto &p: A)
+            if (p.size() > i && equal(prev.begin(), prev.begin() + i,
+                                      p.begin()))
+              xe[p[i]] = true;
+
+          // Exclude the vertexes of the root path, but the spur vertex.
+          vertex u = s;
+          for (size_t j = 0; j < i; ++j)
+            {
+              xv[u] = true;
+              u = other(g, es[prev[j]], u);
+            }
+
+          if (auto sp = dijkstra(g, v, t, c, dist, true))
+            {
+              vector<eid> p(prev.begin(), prev.begin() + i);
+              p.insert(p.end(), sp.value().begin(), sp.value().end());
+              COST l = length(g, es, p);
+              B.emplace(l, std::move(p));
+            }
+
+          v = other(g, es[prev[i]], v);
+        }
+
+      if (B.empty())
+        break;
+
+      A.push_back(B.begin()->second);
+      B.erase(B.begin());
+    }
+
+  return A;
+}
+
+// The up to k edge-disjoint path pairs from a to b of the smallest
+// total length, shorter path of a pair first.  The edge descriptors
+// es are indexed with the edge ID.
+static vector<pair<vector<eid>, vector<eid>>>
+get_pairs(const graph &g, const vector<edge> &es, vertex a, vertex b,
+          unsigned k)
+{
+  // The candidates with the total length, in the order of the total
+  // length, and then of the paths.
+  using cand_t = tuple<COST, vector<eid>, vector<eid>>;
+  vector<cand_t> cs;
+
+  if (auto sp = suurballe(g, es, a, b))
+    {
+      auto &[p1, p2] = sp.value();
+      COST l = length(g, es, p1) + length(g, es, p2);
+      cs.emplace_back(l, std::move(p1), std::move(p2));
+    }
+
+  // The paths are sorted by length, and then by the edge IDs, and so
+  // are the paths of a pair.
+  auto ps = yen(g, es, a, b, 2 * k);
+  vector<bool> on(es.size());
+  for (size_t i = 0; i < ps.size(); ++i)
+    {
+      for (eid e: ps[i])
+        on[e] = true;
+
+      for (size_t j = i + 1; j < ps.size(); ++j)
+        if (none_of(ps[j].begin(), ps[j].end(),
+                    [&on](eid e){return on[e];}))
+          cs.emplace_back(length(g, es, ps[i]) + length(g, es, ps[j]),
+                          ps[i], ps[j]);
+
+      for (eid e: ps[i])
+        on[e] = false;
+    }
+
+  sort(cs.begin(), cs.end());
+  cs.erase(unique(cs.begin(), cs.end()), cs.end());
+  cs.resize(min<size_t>(cs.size(), k));
+
+  vector<pair<vector<eid>, vector<eid>>> result;
+  for (auto &[l, p1, p2]: cs)
+    result.emplace_back(std::move(p1), std::move(p2));
+
+  return result;
+}
+
+size_t
+ksp_table::index(vertex a, vertex b)
+{
+  assert(a != b);
+  if (b < a)
+    swap(a, b);
+
+  return b * (b - 1) / 2 + a;
+}
+
+void
+ksp_table::build(const graph &g, unsigned k, unsigned threads)
+{
+  auto n = num_vertices(g);
+  m_edges = get_edges(g);
+
+  // The candidates of the node pairs, indexed with the node pair
+  // index, found in parallel.
+  vector<vector<pair<vector<eid>, vector<eid>>>> cs(n * (n - 1) / 2);
+
+  // The larger vertex of the next node pairs to do.
+  atomic<vertex> next(1);
+
+  auto worker = [&]()
+                {
+                  for (vertex b; (b = next++) < n;)
+                    for (vertex a = 0; a < b; ++a)
+                      cs[index(a, b)] = get_pairs(g, m_edges, a, b, k);
+                };
+
+  // The calling thread is a worker too.
+  vector<thread> ts;
+  for (unsigned i = 1; i < max(1u, threads); ++i)
+    ts.emplace_back(worker);
+  worker();
+  for (auto &t: ts)
+    t.join();
+
+  m_ids.clear();
+  m_cands.clear();
+  m_first.clear();
+
+  for (const auto &pcs: cs)
+    {
+      m_first.push_back(m_cands.size());
+
+      for (const auto &[p1, p2]: pcs)
+        {
+          m_cands.push_back({unsigned(m_ids.size()), unsigned(p1.size()),
+                             unsigned(p2.size())});
+          m_ids.insert(m_ids.end(), p1.begin(), p1.end());
+          m_ids.insert(m_ids.end(), p2.begin(), p2.end());
+        }
+    }
+
+  m_first.push_back(m_cands.size());
+
+  m_ids.shrink_to_fit();
+  m_cands.shrink_to_fit();
+}
+
+pair<const ksp_table::cand_t *, const ksp_table::cand_t *>
+ksp_table::candidates(vertex a, vertex b) const
+{
+  size_t i = index(a, b);
+  assert(i + 1 < m_first.size());
+
+  return {m_cands.data() + m_first[i], m_cands.data() + m_first[i + 1]};
+}
+
+// Fit the path of the edge IDs [first, last), taken in reverse if
+// reverse: the first-fit CU of the units required for the length of
+// the path, in the SU available on all its edges and within cu.
+static optional<cupath>
+fit(const graph &g, const vector<edge> &es, const eid *first,
+    const eid *last, bool reverse, int ncu, const CU &cu)
+{
+  path p;
+  // The length, summed from the source of the demand, as the
+  // searches do.
+  COST l = 0;
+  SU su{cu};
+
+  for (ptrdiff_t i = 0, n = last - first; i < n; ++i)
+    {
+      const edge &e = es[reverse ? last[-1 - i] : first[i]];
+      l += boost::get(boost::edge_weight, g, e);
+      su = intersection(su, boost::get(boost::edge_su, g, e));
+      if (su.empty())
+        return {};
+      p.push_back(e);
+    }
+
+  int units = adaptive_units<COST>::units(ncu, l);
+  su.remove(units);
+  if (su.empty())
+    return {};
+
+  // First-fit spectrum allocation policy.
+  const CU &c = su.front();
+  return cupath(CU(c.min(), c.min() + units), std::move(p));
+}
+
+optional<cupp>
+fit(const graph &g, const vector<edge> &es, const eid *ids, unsigned n1,
+    unsigned n2, bool reverse, int ncu, const CU &cu)
+{
+  auto p1 = fit(g, es, ids, ids + n1, reverse, ncu, cu);
+  if (!p1)
+    return {};
+
+  auto p2 = fit(g, es, ids + n1, ids + n1 + n2, reverse, ncu, cu);
+  if (!p2)
+    return {};
+
+  if (get_cost(g, p1.value()) <= get_cost(g, p2.value()))
+    return cupp(std::move(p1.value()), std::move(p2.value()));
+
+  return cupp(std::move(p2.value()), std::move(p1.value()));
+}
+
+optional<cupp>
+ksp(const graph &g, const ksp_table &t, const demand &d, const CU &cu)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  // The number of contiguous units.
+  int ncu = d.second;
+
+  // The paths of the table lead from the smaller vertex.
+  bool reverse = dst < src;
+
+  optional<cupp> result;
+  // The cost of the result.
+  COST best = 0;
+
+  for (auto [c, last] = t.candidates(src, dst); c != last; ++c)
+    if (auto p = fit(g, t.edge_table(), t.ids(*c), c->m_n1, c->m_n2,
+                     reverse, ncu, cu))
+      if (COST pc = get_cost(g, p.value()); !result || pc < best)
+        {
+          best = pc;
+          result = std::move(p);
+        }
+
+  return result;
+}
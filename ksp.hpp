@@ -0,0 +1,113 @@
+#ifndef KSP_HPP
+#define KSP_HPP
+
+#include "graph.hpp"
+#include "units.hpp"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+// The table of the candidate path pairs.  For every node pair, it
+// keeps up to k edge-disjoint path pairs of the smallest total length:
+// the shortest pair found with the Suurballe algorithm, and the
+// disjoint pairs of the 2k shortest paths found with the Yen
+// algorithm.  The edge weights do not change, and so the table is
+// built once, and then only read, which threads can do concurrently.
+//
+// The edge IDs of the paths of all candidates are kept in one array,
+// and a candidate is an offset with the numbers of edges of its
+// paths.  A node pair and its reverse share the candidates, since the
+// graph is undirected.
+class ksp_table
+{
+public:
+  // The candidate path pair: the offset of the edge IDs of the first
+  // path in the array, followed by the edge IDs of the second path,
+  // and the numbers of the edges of the paths.  The paths lead from
+  // the smaller to the larger vertex of the node pair.
+  struct cand_t
+  {
+    unsigned m_off;
+    unsigned m_n1;
+    unsigned m_n2;
+  };
+
+private:
+  // The edge IDs of the paths of the candidates.
+  std::vector<eid> m_ids;
+
+  // The candidates of all node pairs.
+  std::vector<cand_t> m_cands;
+
+  // The index of the first candidate of a node pair in m_cands,
+  // indexed with the node pair index, and then the end of m_cands.
+  std::vector<unsigned> m_first;
+
+  // The edge descriptors indexed with the edge ID.
+  std::vector<edge> m_edges;
+
+  // The index of the node pair of different vertexes a and b.
+  static std::size_t
+  index(vertex a, vertex b);
+
+public:
+  // Build the table of k candidates per node pair with the given
+  // number of threads.
+  void
+  build(const graph &g, unsigned k, unsigned threads);
+
+  // The candidates [first, last) of the node pair, cheapest first.
+  std::pair<const cand_t *, const cand_t *>
+  candidates(vertex a, vertex b) const;
+
+  // The edge IDs of the first path of the candidate, followed by the
+  // edge IDs of the second path.
+  const eid *
+  ids(const cand_t &c) const
+  {
+    return m_ids.data() + c.m_off;
+  }
+
+  // The edge descriptors indexed with the edge ID.
+  const std::vector<edge> &
+  edge_table() const
+  {
+    return m_edges;
+  }
+};
+
+// The shortest pair of edge-disjoint paths from s to t, found with the
+// Suurballe algorithm, as the edge IDs of the paths in the order from
+// s to t, shorter path first.  The edge descriptors es are indexed
+// with the edge ID.  If given, usable tells the edges, indexed with
+// the edge ID, that the paths can use.
+std::optional<std::pair<std::vector<eid>, std::vector<eid>>>
+suurballe(const graph &g, const std::vector<edge> &es, vertex s, vertex t,
+          const std::vector<bool> *usable = nullptr);
+
+// The up to k shortest paths from s to t, found with the Yen
+// algorithm, as the edge IDs of the paths in the order from s to t,
+// shortest first.  The edge descriptors es are indexed with the edge
+// ID.
+std::vector<std::vector<eid>>
+yen(const graph &g, const std::vector<edge> &es, vertex s, vertex t,
+    unsigned k);
+
+// Fit the path pair of the edge IDs: the first path of n1 edges,
+// followed by the second path of n2 edges, taken in reverse if
+// reverse.  A path gets the units required for its length with the
+// first fit in the SU available on all its edges and within cu.  The
+// edge descriptors es are indexed with the edge ID.  The cheaper path
+// is returned first.
+std::optional<cupp>
+fit(const graph &g, const std::vector<edge> &es, const eid *ids,
+    unsigned n1, unsigned n2, bool reverse, int ncu, const CU &cu);
+
+// The search over the candidate path pairs of the table: the
+// cheapest candidate that fits is returned.  The result need not be
+// optimal.
+std::optional<cupp>
+ksp(const graph &g, const ksp_table &t, const demand &d, const CU &cu);
+
+#endif // KSP_HPP
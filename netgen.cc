@@ -0,0 +1,663 @@
+// The generator of synthetic networks for the scaling studies.  The
+// networks are written in the graphviz format that load_graphviz
+// reads, with the nodes named as in nets/, e.g., "v0001".  Every
+// network generated is 2-edge-connected, as required for the path
+// pairs.
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+namespace po = boost::program_options;
+
+// The generator arguments.
+struct netgen_args
+{
+  // The model of the network.
+  string model;
+  // The number of nodes.
+  int nodes;
+  // The mean node degree.
+  double degree;
+  // The number of rows of the grid and the torus, 0 for automatic.
+  int rows;
+  // The number of rings of the ring-of-rings model.
+  int rings;
+  // The alpha parameter of the Waxman model.
+  double alpha;
+  // The weight distribution.
+  string weights;
+  // The minimal and the maximal weight of the uniform distribution.
+  int wmin;
+  int wmax;
+  // The mean weight of the exponential distribution.
+  double wmean;
+  // The side length of the square for the distance weights.
+  double side;
+  // The seed.
+  int seed;
+  // The output file name, empty for the standard output.
+  string output;
+  // The demands file name, empty if not requested.
+  string demands;
+  // The number of demands.
+  int ndemands;
+  // The maximal number of contiguous units of a demand.
+  int mnu;
+};
+
+netgen_args
+process_netgen_args(int argc, const char *argv[])
+{
+  netgen_args result;
+
+  po::options_description opts("Allowed options");
+  opts.add_options()
+    ("help,h", "produce help message")
+
+    ("model", po::value<string>(&result.model)->required(),
+     "the model: waxman, grid, torus, ba, rings")
+
+    ("nodes", po::value<int>(&result.nodes)->required(),
+     "the number of nodes")
+
+    ("degree", po::value<double>(&result.degree)->default_value(3),
+     "the mean node degree")
+
+    ("rows", po::value<int>(&result.rows)->default_value(0),
+     "the number of rows of the grid and the torus")
+
+    ("rings", po::value<int>(&result.rings)->default_value(4),
+     "the number of rings of the ring-of-rings model")
+
+    ("alpha", po::value<double>(&result.alpha)->default_value(0.15),
+     "the alpha parameter of the Waxman model")
+
+    ("weights", po::value<string>(&result.weights)
+     ->default_value("distance"),
+     "the weights: distance, uniform, exponential")
+
+    ("wmin", po::value<int>(&result.wmin)->default_value(10),
+     "the minimal weight of the uniform weights")
+
+    ("wmax", po::value<int>(&result.wmax)->default_value(200),
+     "the maximal weight of the uniform weights")
+
+    ("wmean", po::value<double>(&result.wmean)->default_value(100),
+     "the mean weight of the exponential weights")
+
+    ("side", po::value<double>(&result.side)->default_value(1000),
+     "the side of the square for the distance weights")
+
+    ("seed", po::value<int>(&result.seed)->default_value(1),
+     "the seed of the random number generator")
+
+    ("output", po::value<string>(&result.output),
+     "the output file name, the standard output if not given")
+
+    ("demands", po::value<string>(&result.demands),
+     "the demands file name for ddpp_bench")
+
+    ("ndemands", po::value<int>(&result.ndemands)->default_value(100),
+     "the number of demands")
+
+    ("mnu", po::value<int>(&result.mnu)->default_value(4),
+     "the maximal number of contiguous units of a demand");
+
+  try
+    {
+      po::variables_map vm;
+      po::store(po::command_line_parser(argc, argv).options(opts).run(),
+                vm);
+
+      if (vm.count("help"))
+        {
+          cout << opts << "\n";
+          exit(0);
+        }
+
+      po::notify(vm);
+
+      const set<string> models = {"waxman", "grid", "torus", "ba",
+                                  "rings"};
+      if (!models.count(result.model))
+        throw po::error("unknown model '" + result.model + "'");
+
+      const set<string> weights = {"distance", "uniform", "exponential"};
+      if (!weights.count(result.weights))
+        throw po::error("unknown weights '" + result.weights + "'");
+
+      if (result.nodes < 3)
+        throw po::error("there should be at least 3 nodes");
+
+      if (result.degree < 2 || result.degree >= result.nodes - 1)
+        throw po::error("the degree should be from 2 to nodes - 1");
+
+      if (result.wmin < 1 || result.wmax < result.wmin)
+        throw po::error("wrong uniform weights");
+
+      if (result.mnu < 1)
+        throw po::error("mnu should be at least 1");
+    }
+  catch(const std::exception& e)
+    {
+      cerr << e.what() << std::endl;
+      exit(1);
+    }
+
+  return result;
+}
+
+// The network being generated: the node positions in the unit
+// square, and the undirected edges with no parallel edges and no
+// loops.
+struct net
+{
+  // The node positions.
+  vector<pair<double, double>> m_pos;
+  // The edges, the smaller node first.
+  set<pair<int, int>> m_edges;
+  // The adjacency lists.
+  vector<vector<int>> m_adj;
+
+  net(int n): m_pos(n), m_adj(n)
+  {
+  }
+
+  int
+  size() const
+  {
+    return m_pos.size();
+  }
+
+  // Add the edge, unless it is a loop, or it already exists.
+  bool
+  add(int u, int v)
+  {
+    if (u == v || !m_edges.insert(minmax(u, v)).second)
+      return false;
+
+    m_adj[u].push_back(v);
+    m_adj[v].push_back(u);
+    return true;
+  }
+
+  double
+  distance(int u, int v) const
+  {
+    return hypot(m_pos[u].first - m_pos[v].first,
+                 m_pos[u].second - m_pos[v].second);
+  }
+
+  double
+  degree() const
+  {
+    return 2.0 * m_edges.size() / size();
+  }
+};
+
+// A random number from 0 to n - 1.
+template <typename E>
+size_t
+get_random(size_t n, E &eng)
+{
+  return uniform_int_distribution<size_t>(0, n - 1)(eng);
+}
+
+// Place the nodes uniformly in the unit square.
+template <typename E>
+void
+place_uniformly(net &n, E &eng)
+{
+  uniform_real_distribution<> d;
+  for (auto &p: n.m_pos)
+    p = {d(eng), d(eng)};
+}
+
+// The Waxman model: the probability of an edge decreases
+// exponentially with the distance.  The beta parameter is calculated
+// to get the requested mean degree.
+template <typename E>
+void
+waxman(net &n, double degree, double alpha, E &eng)
+{
+  place_uniformly(n, eng);
+
+  const double L = sqrt(2.0);
+  auto f = [&](int u, int v)
+           {
+             return exp(-n.distance(u, v) / (alpha * L));
+           };
+
+  double sum = 0;
+  for (int u = 0; u < n.size(); ++u)
+    for (int v = u + 1; v < n.size(); ++v)
+      sum += f(u, v);
+
+  double beta = min(1.0, degree * n.size() / 2 / sum);
+
+  uniform_real_distribution<> d;
+  for (int u = 0; u < n.size(); ++u)
+    for (int v = u + 1; v < n.size(); ++v)
+      if (d(eng) < beta * f(u, v))
+        n.add(u, v);
+}
+
+// The grid model, and the torus model if wrap is true.  The number
+// of nodes should be divisible by the number of rows.
+void
+grid(net &n, int rows, bool wrap)
+{
+  if (!rows)
+    for (rows = sqrt(n.size()); n.size() % rows; --rows);
+
+  if (n.size() % rows)
+    {
+      cerr << "The number of nodes is not divisible by "
+           << "the number of rows.\n";
+      exit(1);
+    }
+
+  int cols = n.size() / rows;
+  auto id = [cols](int r, int c)
+            {
+              return r * cols + c;
+            };
+
+  for (int r = 0; r < rows; ++r)
+    for (int c = 0; c < cols; ++c)
+      {
+        n.m_pos[id(r, c)] = {(c + 0.5) / cols, (r + 0.5) / rows};
+
+        if (c + 1 < cols || (wrap && cols > 2))
+          n.add(id(r, c), id(r, (c + 1) % cols));
+        if (r + 1 < rows || (wrap && rows > 2))
+          n.add(id(r, c), id((r + 1) % rows, c));
+      }
+}
+
+// The Barabási–Albert model: a new node attaches to m existing nodes
+// chosen with the probability proportional to their degree.  The
+// mean degree is about 2 m.
+template <typename E>
+void
+ba(net &n, double degree, E &eng)
+{
+  place_uniformly(n, eng);
+
+  int m = max(1, static_cast<int>(round(degree / 2)));
+
+  // Every node is listed as many times as its degree.
+  vector<int> targets;
+
+  // Start with the clique of m + 1 nodes.
+  for (int u = 0; u <= m; ++u)
+    for (int v = u + 1; v <= m; ++v)
+      if (n.add(u, v))
+        {
+          targets.push_back(u);
+          targets.push_back(v);
+        }
+
+  for (int u = m + 1; u < n.size(); ++u)
+    {
+      set<int> chosen;
+      uniform_int_distribution<> d(0, targets.size() - 1);
+      while (chosen.size() < static_cast<size_t>(m))
+        chosen.insert(targets[d(eng)]);
+
+      for (int v: chosen)
+        if (n.add(u, v))
+          {
+            targets.push_back(u);
+            targets.push_back(v);
+          }
+    }
+}
+
+// The ring-of-rings model: the nodes are split into rings, and the
+// neighboring rings are connected with two edges.
+void
+rings(net &n, int nr)
+{
+  if (nr < 1 || n.size() < 3 * nr)
+    {
+      cerr << "There should be at least 3 nodes per ring.\n";
+      exit(1);
+    }
+
+  // The first node and the size of every ring.
+  vector<pair<int, int>> rs;
+  for (int i = 0, f = 0; i < nr; ++i)
+    {
+      int s = n.size() / nr + (i < n.size() % nr);
+      rs.push_back({f, s});
+      f += s;
+    }
+
+  // The radius of a ring.
+  double r = min(0.1, 0.3 * sin(M_PI / nr));
+
+  for (int i = 0; i < nr; ++i)
+    {
+      auto [f, s] = rs[i];
+      double a = 2 * M_PI * i / nr;
+      double cx = 0.5 + (nr > 1) * 0.35 * cos(a);
+      double cy = 0.5 + (nr > 1) * 0.35 * sin(a);
+
+      for (int j = 0; j < s; ++j)
+        {
+          double b = 2 * M_PI * j / s;
+          n.m_pos[f + j] = {cx + r * cos(b), cy + r * sin(b)};
+          n.add(f + j, f + (j + 1) % s);
+        }
+
+      if (nr > 1)
+        {
+          auto [g, t] = rs[(i + 1) % nr];
+          n.add(f, g);
+          n.add(f + s / 2, g + t / 2);
+        }
+    }
+}
+
+// Add random edges until the mean degree is reached.
+template <typename E>
+void
+add_random_edges(net &n, double degree, E &eng)
+{
+  uniform_int_distribution<> d(0, n.size() - 1);
+  while (n.degree() < degree)
+    n.add(d(eng), d(eng));
+}
+
+// The connected components: the component number of every node.
+// The bridges, if given, are not traversed.
+int
+components(const net &n, vector<int> &comp,
+           const set<pair<int, int>> &bridges = {})
+{
+  comp.assign(n.size(), -1);
+  int nc = 0;
+
+  for (int s = 0; s < n.size(); ++s)
+    if (comp[s] < 0)
+      {
+        vector<int> stack = {s};
+        comp[s] = nc;
+
+        while (!stack.empty())
+          {
+            int u = stack.back();
+            stack.pop_back();
+
+            for (int v: n.m_adj[u])
+              if (comp[v] < 0 && !bridges.count(minmax(u, v)))
+                {
+                  comp[v] = nc;
+                  stack.push_back(v);
+                }
+          }
+
+        ++nc;
+      }
+
+  return nc;
+}
+
+// Find the bridges with the iterative Tarjan's algorithm.  The
+// network is connected and has no parallel edges.
+set<pair<int, int>>
+bridges(const net &n)
+{
+  set<pair<int, int>> result;
+
+  vector<int> tin(n.size(), -1), low(n.size());
+  // The stack of the node, its parent, and the next neighbor index.
+  vector<tuple<int, int, size_t>> stack = {{0, -1, 0}};
+  int timer = 0;
+  tin[0] = low[0] = timer++;
+
+  while (!stack.empty())
+    {
+      auto &[u, p, i] = stack.back();
+
+      if (i < n.m_adj[u].size())
+        {
+          int v = n.m_adj[u][i++];
+
+          if (v == p)
+            continue;
+
+          if (tin[v] < 0)
+            {
+              tin[v] = low[v] = timer++;
+              stack.push_back({v, u, 0});
+            }
+          else
+            low[u] = min(low[u], tin[v]);
+        }
+      else
+        {
+          int w = u, q = p;
+          stack.pop_back();
+
+          if (q >= 0)
+            {
+              low[q] = min(low[q], low[w]);
+              if (low[w] > tin[q])
+                result.insert(minmax(q, w));
+            }
+        }
+    }
+
+  return result;
+}
+
+// Make the network 2-edge-connected.  First the connected components
+// are connected in a chain.  Then the leaves of the bridge tree are
+// connected: the leaves in the DFS order, the i-th with the (i +
+// L/2)-th, which leaves no bridges.  It is repeated to be sure.
+template <typename E>
+void
+make_2_edge_connected(net &n, E &eng)
+{
+  auto pick = [&](const vector<int> &comp, int c)
+              {
+                vector<int> vs;
+                for (int v = 0; v < n.size(); ++v)
+                  if (comp[v] == c)
+                    vs.push_back(v);
+                return vs[get_random(vs.size(), eng)];
+              };
+
+  vector<int> comp;
+  int nc = components(n, comp);
+  for (int c = 0; c + 1 < nc; ++c)
+    n.add(pick(comp, c), pick(comp, c + 1));
+
+  for (auto bs = bridges(n); !bs.empty(); bs = bridges(n))
+    {
+      // The 2-edge-connected components are the nodes of the bridge
+      // tree, and the bridges are its edges.
+      int nc = components(n, comp, bs);
+      vector<vector<int>> tree(nc);
+      for (auto [u, v]: bs)
+        {
+          tree[comp[u]].push_back(comp[v]);
+          tree[comp[v]].push_back(comp[u]);
+        }
+
+      // The leaves in the DFS order.
+      vector<int> leaves;
+      vector<bool> visited(nc);
+      vector<int> stack = {0};
+      while (!stack.empty())
+        {
+          int c = stack.back();
+          stack.pop_back();
+          if (visited[c])
+            continue;
+          visited[c] = true;
+          if (tree[c].size() == 1)
+            leaves.push_back(c);
+          for (int d: tree[c])
+            if (!visited[d])
+              stack.push_back(d);
+        }
+
+      int L = leaves.size();
+      for (int i = 0; i < (L + 1) / 2; ++i)
+        {
+          int a = leaves[i], b = leaves[(i + L / 2) % L];
+          // Try a few times, since the edge could already exist.
+          for (int t = 0; t < 100 && !n.add(pick(comp, a),
+                                             pick(comp, b)); ++t);
+        }
+    }
+}
+
+// Draw the weights of the edges.
+template <typename E>
+vector<int>
+draw_weights(const net &n, const netgen_args &args, E &eng)
+{
+  vector<int> result;
+
+  uniform_int_distribution<> ud(args.wmin, args.wmax);
+  exponential_distribution<> ed(1 / args.wmean);
+
+  for (auto [u, v]: n.m_edges)
+    {
+      double w;
+
+      if (args.weights == "distance")
+        w = n.distance(u, v) * args.side;
+      else if (args.weights == "uniform")
+        w = ud(eng);
+      else
+        w = ed(eng);
+
+      result.push_back(max(1, static_cast<int>(round(w))));
+    }
+
+  return result;
+}
+
+// The names of the nodes.
+vector<string>
+names(const net &n)
+{
+  int width = to_string(n.size()).size();
+  vector<string> result;
+
+  for (int v = 1; v <= n.size(); ++v)
+    {
+      ostringstream os;
+      os << 'v' << setw(width) << setfill('0') << v;
+      result.push_back(os.str());
+    }
+
+  return result;
+}
+
+void
+write_graphviz(ostream &os, const net &n, const vector<int> &ws)
+{
+  auto ns = names(n);
+
+  os << "graph G {\n";
+
+  for (const auto &name: ns)
+    os << name << ";\n";
+
+  auto wi = ws.begin();
+  for (auto [u, v]: n.m_edges)
+    os << ns[u] << "--" << ns[v] << "  [weight=" << *wi++ << "];\n";
+
+  os << "}\n";
+}
+
+// Write the demands for ddpp_bench.
+template <typename E>
+void
+write_demands(ostream &os, const net &n, int nd, int mnu, E &eng)
+{
+  auto ns = names(n);
+  uniform_int_distribution<> vd(0, n.size() - 1);
+  uniform_int_distribution<> ud(1, mnu);
+
+  for (int i = 0; i < nd; ++i)
+    {
+      int src = vd(eng), dst;
+      while ((dst = vd(eng)) == src);
+      os << ns[src] << " " << ns[dst] << " " << ud(eng) << "\n";
+    }
+}
+
+int
+main(int argc, const char *argv[])
+{
+  netgen_args args = process_netgen_args(argc, argv);
+
+  std::default_random_engine eng(args.seed);
+  net n(args.nodes);
+
+  if (args.model == "waxman")
+    waxman(n, args.degree, args.alpha, eng);
+  else if (args.model == "grid" || args.model == "torus")
+    grid(n, args.rows, args.model == "torus");
+  else if (args.model == "ba")
+    ba(n, args.degree, eng);
+  else
+    rings(n, args.rings);
+
+  make_2_edge_connected(n, eng);
+  add_random_edges(n, args.degree, eng);
+
+  auto ws = draw_weights(n, args, eng);
+
+  if (args.output.empty())
+    write_graphviz(cout, n, ws);
+  else
+    {
+      ofstream os(args.output);
+      if (!os)
+        {
+          cerr << "Error opening a graphviz file '" << args.output
+               << "'.\n";
+          return 1;
+        }
+      write_graphviz(os, n, ws);
+    }
+
+  if (!args.demands.empty())
+    {
+      ofstream os(args.demands);
+      if (!os)
+        {
+          cerr << "Error opening a demands file '" << args.demands
+               << "'.\n";
+          return 1;
+        }
+      write_demands(os, n, args.ndemands, args.mnu, eng);
+    }
+
+  cerr << "nodes " << n.size() << ", edges " << n.m_edges.size()
+       << ", mean degree " << n.degree() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,233 @@
+#include "occupancy.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+void
+occupancy::reset(const graph &g)
+{
+  m_nou = 0;
+  for (const auto &e: boost::make_iterator_range(boost::edges(g)))
+    m_nou = std::max(m_nou, boost::get(boost::edge_nou, g, e));
+
+  unsigned ne = boost::num_edges(g);
+  m_wpe = (m_nou + m_wb - 1) / m_wb;
+
+  // Initially all units are taken, and then we clear the bits of the
+  // units that are available.
+  m_bits.assign(ne * m_wpe, ~word_t(0));
+  m_free.assign(ne, 0);
+  m_frags.assign(ne, 0);
+  m_total_free = 0;
+  m_total_frags = 0;
+  m_clock = 0;
+  m_epochs.assign(ne, 0);
+
+  for (const auto &e: boost::make_iterator_range(boost::edges(g)))
+    {
+      unsigned i = boost::get(boost::edge_index, g, e);
+      assert(i < ne);
+      const SU &su = boost::get(boost::edge_su, g, e);
+
+      for (const auto &cu: su)
+        assign(i, cu.min(), cu.max(), false);
+
+      m_free[i] = su.count();
+      m_frags[i] = su.size();
+      m_total_free += m_free[i];
+      m_total_frags += m_frags[i];
+    }
+}
+
+void
+occupancy::take(unsigned e, const CU &cu)
+{
+  assert(cu.max() <= m_nou);
+  assert(all(e, cu.min(), cu.max(), false));
+
+  // The fragment of cu is split into the fragments on the left and
+  // on the right of cu, if there are any.
+  bool left = cu.min() && is_free(e, cu.min() - 1);
+  bool right = cu.max() < m_nou && is_free(e, cu.max());
+  int df = int(left) + int(right) - 1;
+
+  assign(e, cu.min(), cu.max(), true);
+  m_epochs[e] = ++m_clock;
+
+  m_free[e] -= cu.count();
+  m_total_free -= cu.count();
+  m_frags[e] += df;
+  m_total_frags += df;
+}
+
+void
+occupancy::give(unsigned e, const CU &cu)
+{
+  assert(cu.max() <= m_nou);
+  assert(all(e, cu.min(), cu.max(), true));
+
+  // The units of cu merge with the fragments on the left and on the
+  // right of cu, if there are any.
+  bool left = cu.min() && is_free(e, cu.min() - 1);
+  bool right = cu.max() < m_nou && is_free(e, cu.max());
+  int df = 1 - int(left) - int(right);
+
+  assign(e, cu.min(), cu.max(), false);
+  m_epochs[e] = ++m_clock;
+
+  m_free[e] += cu.count();
+  m_total_free += cu.count();
+  m_frags[e] += df;
+  m_total_frags += df;
+}
+
+bool
+occupancy::is_free(unsigned e, unsigned u) const
+{
+  assert(u < m_nou);
+  const word_t &w = m_bits[e * m_wpe + u / m_wb];
+  return !(w >> (u % m_wb) & 1);
+}
+
+unsigned
+occupancy::num_edges() const
+{
+  return m_free.size();
+}
+
+unsigned
+occupancy::num_words() const
+{
+  return m_wpe;
+}
+
+void
+occupancy::windows(unsigned e, unsigned n, word_t *out) const
+{
+  assert(n);
+  const word_t *row = &m_bits[e * m_wpe];
+
+  for (unsigned i = 0; i < m_wpe; ++i)
+    out[i] = ~row[i];
+
+  // The bitmap of the windows of l units is ANDed with itself shifted
+  // by k units, which makes the bitmap of the windows of l + k units,
+  // and so l reaches n in O(log n) steps.
+  for (unsigned l = 1; l < n;)
+    {
+      unsigned k = std::min(l, n - l);
+      unsigned ws = k / m_wb;
+      unsigned bs = k % m_wb;
+
+      // Bit s gets bit s + k, and the units beyond the bitmap are
+      // taken.  A word is ANDed with the words that follow it, which
+      // are not updated yet.
+      for (unsigned i = 0; i < m_wpe; ++i)
+        {
+          word_t lo = i + ws < m_wpe ? out[i + ws] : 0;
+          word_t hi = i + ws + 1 < m_wpe ? out[i + ws + 1] : 0;
+          out[i] &= bs ? lo >> bs | hi << (m_wb - bs) : lo;
+        }
+
+      l += k;
+    }
+}
+
+unsigned
+occupancy::num_units() const
+{
+  return m_nou;
+}
+
+unsigned
+occupancy::free_units(unsigned e) const
+{
+  return m_free[e];
+}
+
+unsigned
+occupancy::frags(unsigned e) const
+{
+  return m_frags[e];
+}
+
+double
+occupancy::utilization() const
+{
+  double all = static_cast<double>(num_edges()) * m_nou;
+  return all ? (all - m_total_free) / all : 0;
+}
+
+double
+occupancy::mean_frags() const
+{
+  return num_edges() ?
+    static_cast<double>(m_total_frags) / num_edges() : 0;
+}
+
+unsigned long
+occupancy::clock() const
+{
+  return m_clock;
+}
+
+unsigned long
+occupancy::epoch(unsigned e) const
+{
+  return m_epochs[e];
+}
+
+// The mask of the bits [min, max) of a word, where 0 <= min < max <=
+// 64.
+static std::uint64_t
+mask(unsigned min, unsigned max)
+{
+  std::uint64_t m = ~std::uint64_t(0);
+  if (max < 64)
+    m = (std::uint64_t(1) << max) - 1;
+  return m & ~((std::uint64_t(1) << min) - 1);
+}
+
+void
+occupancy::assign(unsigned e, unsigned min, unsigned max, bool taken)
+{
+  word_t *row = &m_bits[e * m_wpe];
+
+  while (min < max)
+    {
+      unsigned w = min / m_wb;
+      unsigned wmax = std::min(max, (w + 1) * m_wb);
+      word_t m = mask(min % m_wb, wmax - w * m_wb);
+
+      if (taken)
+        row[w] |= m;
+      else
+        row[w] &= ~m;
+
+      min = wmax;
+    }
+}
+
+bool
+occupancy::all(unsigned e, unsigned min, unsigned max, bool taken) const
+{
+  const word_t *row = &m_bits[e * m_wpe];
+
+  while (min < max)
+    {
+      unsigned w = min / m_wb;
+      unsigned wmax = std::min(max, (w + 1) * m_wb);
+      word_t m = mask(min % m_wb, wmax - w * m_wb);
+
+      if ((row[w] & m) != (taken ? m : 0))
+        return false;
+
+      min = wmax;
+    }
+
+  return true;
+}
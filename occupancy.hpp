@@ -0,0 +1,130 @@
+#ifndef OCCUPANCY_HPP
+#define OCCUPANCY_HPP
+
+#include "graph.hpp"
+#include "units.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// The spectrum occupancy of the network.  This is the edges x units
+// matrix of bits, where a set bit means the unit is taken.  The
+// bitmap of an edge is a row of 64-bit words, and the rows are stored
+// edge after edge.  Along with the bitmaps, we keep (in separate
+// arrays) the number of free units and the number of fragments of
+// every edge, and the network-wide totals.  The counts are updated
+// incrementally when units are taken or given back, so reading them
+// costs O(1).
+//
+// The edges are identified with the edge_index property.
+class occupancy
+{
+  // The word type of a bitmap.
+  using word_t = std::uint64_t;
+
+  // The number of bits in a word.
+  static constexpr unsigned m_wb = 64;
+
+  // The number of units, i.e., the number of columns.
+  unsigned m_nou = 0;
+
+  // The number of words per edge.
+  unsigned m_wpe = 0;
+
+  // The bitmaps of the edges.
+  std::vector<word_t> m_bits;
+
+  // The number of free units of the edges.
+  std::vector<unsigned> m_free;
+
+  // The number of fragments of the edges.
+  std::vector<unsigned> m_frags;
+
+  // The total number of free units in the network.
+  unsigned long m_total_free = 0;
+
+  // The total number of fragments in the network.
+  unsigned long m_total_frags = 0;
+
+  // The modification clock, advanced every time units are taken or
+  // given back.
+  unsigned long m_clock = 0;
+
+  // The clock of the last modification of the edges.
+  std::vector<unsigned long> m_epochs;
+
+public:
+  // Build the occupancy from the SUs of the edges of graph g.  The
+  // number of columns is the maximal number of units of an edge, and
+  // the units beyond the number of units of an edge are taken.
+  void
+  reset(const graph &g);
+
+  // Take the units of cu on edge e.  The units must be free.
+  void
+  take(unsigned e, const CU &cu);
+
+  // Give back the units of cu on edge e.  The units must be taken.
+  void
+  give(unsigned e, const CU &cu);
+
+  // True if unit u is free on edge e.
+  bool
+  is_free(unsigned e, unsigned u) const;
+
+  // The number of edges.
+  unsigned
+  num_edges() const;
+
+  // The number of the words of the bitmap of an edge.
+  unsigned
+  num_words() const;
+
+  // Put into out the bitmap of the windows of n free units of edge e,
+  // which has num_words words: bit s is set if units [s, s + n) are
+  // free.  The words are processed whole, which the compiler can
+  // vectorize.
+  void
+  windows(unsigned e, unsigned n, std::uint64_t *out) const;
+
+  // The number of units.
+  unsigned
+  num_units() const;
+
+  // The number of free units on edge e.
+  unsigned
+  free_units(unsigned e) const;
+
+  // The number of fragments on edge e.
+  unsigned
+  frags(unsigned e) const;
+
+  // The network utilization, i.e., the ratio of the units taken to
+  // all units.
+  double
+  utilization() const;
+
+  // The mean number of fragments on an edge.
+  double
+  mean_frags() const;
+
+  // The modification clock.
+  unsigned long
+  clock() const;
+
+  // The clock of the last modification of edge e, i.e., edge e has
+  // not been modified since clock() returned this value.
+  unsigned long
+  epoch(unsigned e) const;
+
+private:
+  // Set or clear the bits [min, max) of edge e.
+  void
+  assign(unsigned e, unsigned min, unsigned max, bool taken);
+
+  // True if all bits [min, max) of edge e have the taken value.
+  bool
+  all(unsigned e, unsigned min, unsigned max, bool taken) const;
+};
+
+#endif // OCCUPANCY_HPP
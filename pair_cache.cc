@@ -0,0 +1,107 @@
+#include "pair_cache.hpp"
+
+#include "ksp.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+
+using namespace std;
+
+void
+pair_cache::reset(unsigned capacity)
+{
+  m_entries.clear();
+  m_capacity = capacity;
+  m_clock = 0;
+}
+
+optional<cupp>
+pair_cache::fit(const graph &g, const vector<edge> &es, const demand &d,
+                const CU &cu)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+
+  auto i = m_entries.find(minmax(src, dst));
+  if (i == m_entries.end())
+    return {};
+
+  // The paths lead from the smaller vertex.
+  bool reverse = dst < src;
+
+  optional<cupp> result;
+  // The cost of the result, and its entry.
+  COST best = 0;
+  entry_t *be = nullptr;
+
+  for (auto &e: i->second)
+    if (auto p = ::fit(g, es, e.m_ids.data(), e.m_n1,
+                       e.m_ids.size() - e.m_n1, reverse, d.second, cu))
+      if (COST pc = get_cost(g, p.value()); !result || pc < best)
+        {
+          best = pc;
+          result = std::move(p);
+          be = &e;
+        }
+
+  if (be)
+    {
+      ++be->m_uses;
+      be->m_used = ++m_clock;
+    }
+
+  return result;
+}
+
+void
+pair_cache::learn(const graph &g, const demand &d, const cupp &p)
+{
+  assert(m_capacity);
+
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+
+  // The edge IDs of the paths, from the smaller vertex.
+  vector<eid> ids[2];
+  for (auto [cp, v]: {pair(&p.first, &ids[0]), pair(&p.second, &ids[1])})
+    {
+      for (const auto &e: cp->second)
+        v->push_back(boost::get(boost::edge_index, g, e));
+      if (dst < src)
+        std::reverse(v->begin(), v->end());
+    }
+
+  if (ids[1] < ids[0])
+    swap(ids[0], ids[1]);
+
+  unsigned n1 = ids[0].size();
+  ids[0].insert(ids[0].end(), ids[1].begin(), ids[1].end());
+
+  auto &es = m_entries[minmax(src, dst)];
+
+  for (auto &e: es)
+    if (e.m_n1 == n1 && e.m_ids == ids[0])
+      {
+        ++e.m_uses;
+        e.m_used = ++m_clock;
+        return;
+      }
+
+  if (es.size() == m_capacity)
+    {
+      auto i = min_element(es.begin(), es.end(),
+                           [](const entry_t &a, const entry_t &b)
+                           {
+                             return tie(a.m_uses, a.m_used) <
+                               tie(b.m_uses, b.m_used);
+                           });
+      es.erase(i);
+
+      for (auto &e: es)
+        e.m_uses /= 2;
+    }
+
+  es.push_back({std::move(ids[0]), n1, 1, ++m_clock});
+}
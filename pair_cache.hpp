@@ -0,0 +1,67 @@
+#ifndef PAIR_CACHE_HPP
+#define PAIR_CACHE_HPP
+
+#include "graph.hpp"
+#include "units.hpp"
+
+#include <map>
+#include <optional>
+#include <vector>
+
+// The cache of the path pairs learned from the results of the
+// searches.  A demand is fit into the path pairs cached for its node
+// pair, as into the candidates of the ksp_table, and so the search
+// has to run only when none fits.  A node pair and its reverse share
+// the path pairs.
+//
+// A node pair keeps up to the capacity of path pairs.  An entry counts
+// its uses, and when a new path pair is learned for a full node pair,
+// the entry of the fewest uses is evicted, the least recently used of
+// them.  Then the counts of the node pair are halved, so that the
+// path pairs used often long ago give way to the new ones.
+class pair_cache
+{
+  // The path pair cached.
+  struct entry_t
+  {
+    // The edge IDs of the first path, followed by the edge IDs of the
+    // second path.  The paths lead from the smaller to the larger
+    // vertex of the node pair, and they are in the order of the edge
+    // IDs.
+    std::vector<eid> m_ids;
+    // The number of the edges of the first path.
+    unsigned m_n1;
+    // The number of uses.
+    unsigned long m_uses;
+    // The time of the last use.
+    unsigned long m_used;
+  };
+
+  // The path pairs indexed with the node pair, smaller vertex first.
+  std::map<npair, std::vector<entry_t>> m_entries;
+
+  // The max number of the path pairs per node pair.
+  unsigned m_capacity = 0;
+
+  // The clock of the uses.
+  unsigned long m_clock = 0;
+
+public:
+  // Clear the cache, and set the capacity per node pair.
+  void
+  reset(unsigned capacity);
+
+  // The cheapest path pair cached for the node pair of the demand
+  // that fits, with the first fit in the SU available on all its
+  // edges and within cu.  The path pair returned is counted as used.
+  // The edge descriptors es are indexed with the edge ID.
+  std::optional<cupp>
+  fit(const graph &g, const std::vector<edge> &es, const demand &d,
+      const CU &cu);
+
+  // Learn the path pair p chosen for the demand.
+  void
+  learn(const graph &g, const demand &d, const cupp &p);
+};
+
+#endif // PAIR_CACHE_HPP
@@ -0,0 +1,108 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// The pool of objects of type T.  The objects are constructed in the
+// slabs of memory owned by the pool, and the memory of a destroyed
+// object goes to the free list to be reused.  The slabs are released
+// only when the pool is destroyed, and so once the pool has grown to
+// the peak number of objects, creating an object allocates no memory.
+//
+// The pool doesn't keep track of the objects created, and so they
+// have to be destroyed before the pool is.
+template <typename T>
+class pool
+{
+  // The storage of an object.  When free, it holds the pointer to the
+  // next free storage.
+  union node
+  {
+    node *m_next;
+    alignas(T) unsigned char m_data[sizeof(T)];
+  };
+
+  // The number of nodes in a slab.
+  const std::size_t m_slab_size;
+
+  // The slabs.
+  std::vector<std::unique_ptr<node[]>> m_slabs;
+
+  // The list of free nodes.
+  node *m_free = nullptr;
+
+  // The number of objects created and not destroyed.
+  std::size_t m_size = 0;
+
+public:
+  pool(std::size_t slab_size = 1024): m_slab_size(slab_size)
+  {
+    assert(slab_size);
+  }
+
+  pool(const pool &) = delete;
+
+  ~pool()
+  {
+    assert(!m_size);
+  }
+
+  // Construct an object with the given arguments.
+  template <typename... Args>
+  T *
+  create(Args &&... args)
+  {
+    if (!m_free)
+      grow();
+
+    node *n = m_free;
+    m_free = n->m_next;
+
+    T *t = new (n->m_data) T(std::forward<Args>(args)...);
+    ++m_size;
+
+    return t;
+  }
+
+  // Destroy the object, and put its storage on the free list.
+  void
+  destroy(T *t)
+  {
+    assert(m_size);
+    t->~T();
+
+    node *n = reinterpret_cast<node *>(t);
+    n->m_next = m_free;
+    m_free = n;
+    --m_size;
+  }
+
+  // The number of objects created and not destroyed.
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  // Allocate a new slab, and put its nodes on the free list.
+  void
+  grow()
+  {
+    node *slab = new node[m_slab_size];
+    m_slabs.emplace_back(slab);
+
+    for (std::size_t i = m_slab_size; i--;)
+      {
+        slab[i].m_next = m_free;
+        m_free = slab + i;
+      }
+  }
+};
+
+#endif // POOL_HPP
@@ -0,0 +1,116 @@
+#include "prepass.hpp"
+
+#include "adaptive_units.hpp"
+
+#include <boost/range.hpp>
+
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+vector<bool>
+feasible_edges(const graph &g, const demand &d)
+{
+  vector<bool> result(num_edges(g));
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    {
+      COST w = boost::get(boost::edge_weight, g, e);
+      int units = adaptive_units<COST>::units(d.second, w);
+
+      // The unreachable distance.
+      if (units == numeric_limits<int>::max())
+        continue;
+
+      for (const auto &cu: boost::get(boost::edge_su, g, e))
+        if (cu.count() >= static_cast<unsigned>(units))
+          {
+            result[boost::get(boost::edge_index, g, e)] = true;
+            break;
+          }
+    }
+
+  return result;
+}
+
+// The number of feasible edges of vertex v.
+static unsigned
+feasible_degree(const graph &g, vertex v, const vector<bool> &mask)
+{
+  unsigned result = 0;
+
+  for (const auto &e: boost::make_iterator_range(out_edges(v, g)))
+    result += mask[boost::get(boost::edge_index, g, e)];
+
+  return result;
+}
+
+// Find an augmenting path from src to dst in the residual network,
+// and augment the flow along it.  The flow of an edge is +1 if it
+// goes from the end vertex of the lower number to the other end
+// vertex, and -1 if it goes the other way.
+static bool
+augment(const graph &g, vertex src, vertex dst, const vector<bool> &mask,
+        vector<int> &flow)
+{
+  // The edge a vertex was reached with, and the visited flags.
+  vector<edge> pred(num_vertices(g));
+  vector<bool> visited(num_vertices(g));
+
+  queue<vertex> q;
+  q.push(src);
+  visited[src] = true;
+
+  while (!q.empty() && !visited[dst])
+    {
+      vertex u = q.front();
+      q.pop();
+
+      for (const auto &e: boost::make_iterator_range(out_edges(u, g)))
+        {
+          unsigned i = boost::get(boost::edge_index, g, e);
+          vertex v = target(e, g);
+
+          // The flow in the direction from u to v.
+          int f = u < v ? flow[i] : -flow[i];
+
+          if (mask[i] && !visited[v] && f < 1)
+            {
+              visited[v] = true;
+              pred[v] = e;
+              q.push(v);
+            }
+        }
+    }
+
+  if (!visited[dst])
+    return false;
+
+  for (vertex v = dst; v != src;)
+    {
+      // The edge was reached from u, so u is its source.
+      const edge &e = pred[v];
+      vertex u = source(e, g);
+      flow[boost::get(boost::edge_index, g, e)] += u < v ? 1 : -1;
+      v = u;
+    }
+
+  return true;
+}
+
+bool
+is_feasible(const graph &g, const demand &d, const vector<bool> &mask)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+
+  if (feasible_degree(g, src, mask) < 2 ||
+      feasible_degree(g, dst, mask) < 2)
+    return false;
+
+  vector<int> flow(num_edges(g));
+
+  return augment(g, src, dst, mask, flow) &&
+    augment(g, src, dst, mask, flow);
+}
@@ -0,0 +1,29 @@
+#ifndef PREPASS_HPP
+#define PREPASS_HPP
+
+#include "graph.hpp"
+
+#include <vector>
+
+// The feasibility pre-pass of a demand, which is run before any
+// search.  It is sound: when it reports that a demand is infeasible,
+// no search can find a path pair for the demand.  It is not
+// complete: a feasible demand can still be blocked.
+
+// The feasible edge mask of the demand, indexed with the edge index.
+// An edge is feasible, if it has a CU of at least the number of
+// units required for a path of the edge length.  No path of the
+// demand can use an infeasible edge, since the required number of
+// units does not decrease with the path length.
+std::vector<bool>
+feasible_edges(const graph &g, const demand &d);
+
+// True if the demand can be feasible: the end nodes have at least two
+// feasible edges each, and the max flow between the end nodes in the
+// subgraph of the feasible edges, with unit edge capacities, is at
+// least 2, i.e., there are two edge-disjoint feasible paths.
+bool
+is_feasible(const graph &g, const demand &d,
+            const std::vector<bool> &mask);
+
+#endif // PREPASS_HPP
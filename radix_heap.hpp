@@ -0,0 +1,195 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// The radix heap of R. Ahuja, K. Mehlhorn, J. Orlin, and R. Tarjan,
+// "Faster algorithms for the shortest path problem", JACM, 1990.  It
+// is a monotone priority queue: a key pushed cannot be smaller than
+// the key popped last, which holds for the label-setting searches.
+//
+// An entry is kept in the bucket of the highest bit in which its key
+// differs from the key popped last, or in bucket 0 if the keys are
+// equal.  When bucket 0 is empty, the entries of the first non-empty
+// bucket are redistributed with their min key as the last key, and
+// they all go to lower buckets.  An entry moves at most 64 times, and
+// so push and pop take amortized O(1) time for 64-bit keys.
+//
+// Of the entries of the same key, the entry of the largest value is
+// popped first, and so the order of popping depends on the entries
+// only, and not on the order of pushing and popping.  Bucket 0 is
+// kept sorted by value, which is cheap, because it holds the entries
+// of a single key, and the searches push the values in increasing
+// order.
+//
+// V is the value type, which has to be less-than comparable.
+template <typename V>
+class radix_heap
+{
+  // The number of buckets: bucket 0, and a bucket for every bit.
+  static constexpr unsigned m_nb = 65;
+
+  using entry = std::pair<std::uint64_t, V>;
+
+  std::array<std::vector<entry>, m_nb> m_buckets;
+
+  // The key popped last.
+  std::uint64_t m_last = 0;
+
+  // The number of entries.
+  std::size_t m_size = 0;
+
+public:
+  bool
+  empty() const
+  {
+    return !m_size;
+  }
+
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  void
+  push(std::uint64_t k, const V &v)
+  {
+    assert(k >= m_last);
+    if (unsigned i = bucket(k); i)
+      m_buckets[i].emplace_back(k, v);
+    else
+      {
+        auto &b = m_buckets[0];
+        b.insert(std::upper_bound(b.begin(), b.end(), v, by_value),
+                 entry(k, v));
+      }
+    ++m_size;
+  }
+
+  // The min key.  The heap cannot be empty.
+  std::uint64_t
+  top_key()
+  {
+    refill();
+    return m_buckets[0].back().first;
+  }
+
+  // The value of the min key.  The heap cannot be empty.
+  const V &
+  top_value()
+  {
+    refill();
+    return m_buckets[0].back().second;
+  }
+
+  // The min key, found without moving the entries, and so unlike
+  // top_key, it does not raise the least key that can be pushed.  It
+  // takes time linear in the size of the first non-empty bucket.  The
+  // heap cannot be empty.
+  std::uint64_t
+  peek_key() const
+  {
+    assert(m_size);
+
+    if (!m_buckets[0].empty())
+      return m_last;
+
+    unsigned i = 1;
+    while (m_buckets[i].empty())
+      ++i;
+
+    std::uint64_t k = m_buckets[i].front().first;
+    for (const auto &e: m_buckets[i])
+      if (e.first < k)
+        k = e.first;
+
+    return k;
+  }
+
+  // Remove the entry of the min key.  The heap cannot be empty.
+  void
+  pop()
+  {
+    refill();
+    m_buckets[0].pop_back();
+    --m_size;
+  }
+
+private:
+  static bool
+  by_value(const V &v, const entry &e)
+  {
+    return v < e.second;
+  }
+
+  unsigned
+  bucket(std::uint64_t k) const
+  {
+    return k == m_last ? 0 : 64 - __builtin_clzll(k ^ m_last);
+  }
+
+  // Make sure bucket 0 holds the entries of the min key.
+  void
+  refill()
+  {
+    assert(m_size);
+
+    if (!m_buckets[0].empty())
+      return;
+
+    unsigned i = 1;
+    while (m_buckets[i].empty())
+      ++i;
+
+    auto &b = m_buckets[i];
+
+    m_last = b.front().first;
+    for (const auto &e: b)
+      if (e.first < m_last)
+        m_last = e.first;
+
+    for (const auto &e: b)
+      m_buckets[bucket(e.first)].push_back(e);
+
+    b.clear();
+
+    auto &b0 = m_buckets[0];
+    std::sort(b0.begin(), b0.end(),
+              [](const entry &x, const entry &y)
+              {
+                return x.second < y.second;
+              });
+  }
+};
+
+// The key of the radix heap for a non-negative double.  The bits of a
+// non-negative IEEE 754 double, read as an unsigned integer, keep the
+// order of the doubles.
+inline std::uint64_t
+to_radix_key(double c)
+{
+  assert(c >= 0);
+  // Turn -0 into 0.
+  c += 0.0;
+  std::uint64_t k;
+  std::memcpy(&k, &c, sizeof(k));
+  return k;
+}
+
+// The double of the radix heap key.
+inline double
+from_radix_key(std::uint64_t k)
+{
+  double c;
+  std::memcpy(&c, &k, sizeof(c));
+  return c;
+}
+
+#endif // RADIX_HEAP_HPP
@@ -10,19 +10,24 @@
 #include "ee.hpp"
 #include "gd.hpp"
 #include "graph.hpp"
+#include "ksp.hpp"
+#include "prepass.hpp"
 #include "stats.hpp"
+#include "sw.hpp"
 #include "units.hpp"
 #include "utils.hpp"
 
 #include <boost/range.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <climits>
 #include <chrono>
 #include <list>
 #include <map>
 #include <optional>
 #include <set>
+#include <thread>
 #include <tuple>
 
 using namespace std;
@@ -30,8 +35,72 @@ using namespace std;
 // Another routing algorithms to use.
 set<routing::rt_t> routing::m_algs;
 
+// The spectrum occupancy.
+occupancy routing::m_occ;
+
+// The edge descriptors.
+vector<edge> routing::m_edges;
+
+// The shortest distances to the destinations.
+dist_table routing::m_dists;
+
+// The feasibility pre-pass is disabled by default.
+bool routing::m_prepass = false;
+
+// The budget of the generic Dijkstra search, with no limits.
+gd_budget routing::m_budget;
+
+// The beam of the generic Dijkstra search with the beam.
+unsigned routing::m_beam = 0;
+
+// The result of the last search.
+bool routing::m_exact = true;
+
+// The speculative searches run in the calling thread only by default.
+unsigned routing::m_threads = 1;
+
+// The cache is disabled by default.
+bool routing::m_cache = false;
+
+// The cached results.
+map<demand, routing::cached_t> routing::m_cached;
+
+// The incremental search is disabled by default.
+bool routing::m_incremental = false;
+
+// The states of the incremental searches.
+vector<gd_state> routing::m_states;
+
+// The cache of the learned path pairs is disabled by default.
+unsigned routing::m_learn = 0;
+
+// The learned path pairs.
+pair_cache routing::m_learned;
+
+// No fit is checked by default.
+unsigned routing::m_verify = 0;
+
+// The number of the fits into the learned path pairs.
+unsigned long routing::m_fits = 0;
+
+// The k shortest path pairs search is disabled by default.
+unsigned routing::m_ksp = 0;
+
+// The table of the candidate path pairs.
+ksp_table routing::m_ksp_table;
+
+// The speculative searches.
+deque<routing::spec_t> routing::m_specs;
+unsigned long routing::m_spec_clock = 0;
+
 optional<cupp>
 routing::set_up(graph &g, const demand &d)
+{
+  return set_up(g, d, get_cu(g, d));
+}
+
+CU
+routing::get_cu(const graph &g, const demand &d)
 {
   vertex src = d.first.first;
 
@@ -43,7 +112,7 @@ routing::set_up(graph &g, const demand &d)
     // The total number of units available on the edge.
     nou = std::max(nou, boost::get(boost::edge_nou, g, e));
 
-  return set_up(g, d, CU(0, nou));
+  return CU(0, nou);
 }
 
 optional<cupp>
@@ -54,13 +123,36 @@ routing::set_up(graph &g, const demand &d, const CU &cu)
 
   assert (src != dst);
 
+  // The speculative result is taken even if the demand is blocked by
+  // the pre-pass, so that the next result is for the next demand.
+  optional<spec_t> spec = take_speculation(d);
+
+  if (m_prepass && !prepass(g, d))
+    return {};
+
   // The path found to be established.
   optional<cupp> p;
 
+  if (spec)
+    {
+      // The speculative search was run for the whole CU.
+      assert(cu == get_cu(g, d));
+      stats::get().algo_perf(rt_t::gd, spec->m_dt, d, spec->m_p);
+      p = spec->m_p.second;
+
+      if (p)
+        set_up(g, p.value());
+
+      return p;
+    }
+
   // The algorithms to use.
   bool gd = m_algs.count(rt_t::gd);
+  bool gdb = m_algs.count(rt_t::gdb);
   bool bf = m_algs.count(rt_t::bf);
   bool ee = m_algs.count(rt_t::ee);
+  bool ksp = m_algs.count(rt_t::ksp);
+  bool sw = m_algs.count(rt_t::sw);
 
   if (gd)
     {
@@ -68,8 +160,8 @@ routing::set_up(graph &g, const demand &d, const CU &cu)
       p = search(g, d, cu, rt_t::gd);
 
       // Corroborate the generic Dijkstra results with the brute force
-      // results.
-      if (bf)
+      // results, unless the budget was exceeded.
+      if (bf && m_exact)
         {
           // The brute force result.
           auto pp = search(g, d, cu, rt_t::bf);
@@ -79,6 +171,66 @@ routing::set_up(graph &g, const demand &d, const CU &cu)
             abort();
         }
 
+      // Measure the quality of the beam search results against the
+      // exact results.
+      if (gdb)
+        {
+          auto pp = search(g, d, cu, rt_t::gdb);
+
+          if (m_exact)
+            stats::get().approx_perf(rt_t::gdb, p, pp);
+        }
+
+      // Measure the quality of the k shortest path pairs results
+      // against the exact results.
+      if (ksp)
+        {
+          auto pp = search(g, d, cu, rt_t::ksp);
+
+          if (m_exact)
+            stats::get().approx_perf(rt_t::ksp, p, pp);
+        }
+
+      // Check the generic Dijkstra results against the slot window
+      // results, which cannot be better.
+      if (sw)
+        {
+          auto pp = search(g, d, cu, rt_t::sw);
+
+          if (m_exact)
+            stats::get().approx_perf(rt_t::sw, p, pp);
+        }
+
+      // We run this research only to report performance, we don't use
+      // its results.
+      if (ee)
+        search(g, d, cu, rt_t::ee);
+    }
+  else if (gdb)
+    {
+      // The generic Dijkstra with the beam results.
+      p = search(g, d, cu, rt_t::gdb);
+
+      // We run this research only to report performance, we don't use
+      // its results.
+      if (ee)
+        search(g, d, cu, rt_t::ee);
+    }
+  else if (ksp)
+    {
+      // The k shortest path pairs results.
+      p = search(g, d, cu, rt_t::ksp);
+
+      // We run this research only to report performance, we don't use
+      // its results.
+      if (ee)
+        search(g, d, cu, rt_t::ee);
+    }
+  else if (sw)
+    {
+      // The slot window results.
+      p = search(g, d, cu, rt_t::sw);
+
       // We run this research only to report performance, we don't use
       // its results.
       if (ee)
@@ -102,26 +254,105 @@ routing::search(graph &g, const demand &d, const CU &cu, rt_t rt)
 {
   using tp_t = chrono::time_point<chrono::high_resolution_clock>;
 
-  pair<array<unsigned long, 4>, optional<cupp>> p;
+  pair<array<unsigned long, 5>, optional<cupp>> p;
+  // The fit into the learned path pairs.
+  optional<cupp> lp;
 
   tp_t t0 = std::chrono::system_clock::now();
 
+  // The shortest distances to the destination, which only gd, gdb
+  // and bf use.  They are calculated once per destination, and so
+  // timed along with the first search of these algorithms only.
+  const vector<COST> *dist = nullptr;
+  if (rt == rt_t::gd || rt == rt_t::gdb || rt == rt_t::bf)
+    dist = &m_dists.to(d.first.second);
+
   switch (rt)
     {
     case rt_t::gd:
-      p = gd(g, d, cu);
+      if (m_budget.m_labels || m_budget.m_time > 0)
+        {
+          gd_budget b = m_budget;
+          p = gd(g, m_edges, d, cu, &b, dist);
+          m_exact = !b.m_hit;
+
+          if (b.m_hit)
+            {
+              // Fall back to the edge exclusion search.
+              bool fallback = !p.second;
+              if (fallback)
+                p.second = ee(g, d, cu);
+
+              stats::get().budget_hit(d, b.m_lb, p.second, fallback);
+            }
+        }
+      // Use the fit into the learned path pairs, or the cached
+      // result, if any, or else run the search.
+      else if (!(m_learn && get_learned(g, d, cu, lp, p)) &&
+               (!m_cache || !get_cached(d, cu, p)))
+        {
+          // No limits, but the number of threads.
+          gd_budget b = m_budget;
+          // The edges read by the search, needed by the cache.
+          vector<eid> reads;
+
+          if (m_incremental)
+            {
+              // Keep the steps of the last search from the source
+              // that read no edge changed since.
+              gd_state &s = m_states[d.first.first];
+              s.invalidate([&](eid e)
+                           {return m_occ.epoch(e) > s.m_clock;});
+
+              p = gd(g, m_edges, d, cu, &b, dist, nullptr, &s);
+              s.m_clock = m_occ.clock();
+
+              if (m_cache)
+                reads = s.m_reads;
+            }
+          else
+            p = gd(g, m_edges, d, cu, &b, dist,
+                   m_cache ? &reads : nullptr);
+
+          if (m_cache)
+            put_cached(d, cu, p, std::move(reads));
+        }
+
+      // Check the fit into the learned path pairs against the exact
+      // result, and learn the exact result.
+      if (m_learn && m_exact)
+        put_learned(g, d, lp, p.second);
+      break;
+
+    case rt_t::gdb:
+      {
+        gd_budget b;
+        b.m_beam = m_beam;
+        b.m_threads = m_budget.m_threads;
+        p = gd(g, m_edges, d, cu, &b, dist);
+      }
       break;
 
     case rt_t::bf:
-      p = make_pair(array<unsigned long, 4>{0, 0, 0, 0},
-                    bf(g, d, cu));
+      p = make_pair(array<unsigned long, 5>{0, 0, 0, 0, 0},
+                    bf(g, m_edges, d, cu, dist));
       break;
 
     case rt_t::ee:
-      p = make_pair(array<unsigned long, 4>{0, 0, 0, 0},
+      p = make_pair(array<unsigned long, 5>{0, 0, 0, 0, 0},
                     ee(g, d, cu));
       break;
 
+    case rt_t::ksp:
+      p = make_pair(array<unsigned long, 5>{0, 0, 0, 0, 0},
+                    ::ksp(g, m_ksp_table, d, cu));
+      break;
+
+    case rt_t::sw:
+      p = make_pair(array<unsigned long, 5>{0, 0, 0, 0, 0},
+                    ::sw(g, m_occ, m_edges, d, cu, m_budget.m_threads));
+      break;
+
     default:
       abort();
     }
@@ -129,27 +360,194 @@ routing::search(graph &g, const demand &d, const CU &cu, rt_t rt)
   tp_t t1 = std::chrono::system_clock::now();
   chrono::duration<double> dt = t1 - t0;
 
-  stats::get().algo_perf(rt, dt.count(), d.second, p);
+  stats::get().algo_perf(rt, dt.count(), d, p);
 
   return p.second;
 }
 
 void
-routing::tear_down(graph &g, const cupath &p)
+routing::speculate(const graph &g, const vector<demand> &ds)
 {
-  boost::property_map<graph, boost::edge_su_t>::type
-    sm = get(boost::edge_su_t(), g);
+  assert(m_specs.empty());
+  assert(m_algs.size() == 1 && m_algs.count(rt_t::gd));
 
-  // Iterate over the edges of the path.
-  for(const auto &e: p.second)
-    sm[e].insert(p.first);
+  m_specs.resize(ds.size());
+  m_spec_clock = m_occ.clock();
+
+  // The distances are calculated here, because the table is not
+  // thread-safe.
+  vector<const vector<COST> *> dists(ds.size());
+  for (size_t i = 0; i < ds.size(); ++i)
+    {
+      m_specs[i].m_d = ds[i];
+      dists[i] = &m_dists.to(ds[i].first.second);
+    }
+
+  // The index of the next search to run.
+  atomic<size_t> next(0);
+
+  auto worker = [&]()
+                {
+                  for (size_t i; (i = next++) < ds.size();)
+                    {
+                      spec_t &s = m_specs[i];
+                      auto t0 = chrono::steady_clock::now();
+                      s.m_p = gd(g, m_edges, s.m_d, get_cu(g, s.m_d),
+                                 nullptr, dists[i], &s.m_reads);
+                      auto t1 = chrono::steady_clock::now();
+                      s.m_dt = chrono::duration<double>(t1 - t0).count();
+
+                      sort(s.m_reads.begin(), s.m_reads.end());
+                      s.m_reads.erase(unique(s.m_reads.begin(),
+                                             s.m_reads.end()),
+                                      s.m_reads.end());
+                    }
+                };
+
+  // The calling thread is a worker too.
+  vector<thread> ts;
+  for (unsigned i = 1; i < min<size_t>(m_threads, ds.size()); ++i)
+    ts.emplace_back(worker);
+  worker();
+  for (auto &t: ts)
+    t.join();
+}
+
+bool
+routing::has_speculations()
+{
+  return !m_specs.empty();
+}
+
+optional<routing::spec_t>
+routing::take_speculation(const demand &d)
+{
+  if (m_specs.empty())
+    return {};
+
+  spec_t s = std::move(m_specs.front());
+  m_specs.pop_front();
+  assert(s.m_d == d);
+
+  // The result is valid if the edges read were not changed since the
+  // speculation: the search would run the same now.
+  bool valid = all_of(s.m_reads.begin(), s.m_reads.end(),
+                      [](eid e)
+                      {return m_occ.epoch(e) <= m_spec_clock;});
+
+  stats::get().spec_perf(valid);
+
+  if (valid)
+    return s;
+
+  return {};
+}
+
+bool
+routing::get_cached(const demand &d, const CU &cu,
+                    pair<array<unsigned long, 5>, optional<cupp>> &p)
+{
+  auto i = m_cached.find(d);
+
+  // The result is valid if the edges read were not changed since the
+  // search: the search would run the same now.
+  bool valid = i != m_cached.end() && i->second.m_cu == cu &&
+    all_of(i->second.m_reads.begin(), i->second.m_reads.end(),
+           [c = i->second.m_clock](eid e)
+           {return m_occ.epoch(e) <= c;});
+
+  stats::get().cache_perf(valid);
+
+  if (valid)
+    p = i->second.m_p;
+
+  return valid;
 }
 
 void
-routing::tear_down(graph &g, const cupp &p)
+routing::put_cached(const demand &d, const CU &cu,
+                    const pair<array<unsigned long, 5>,
+                               optional<cupp>> &p,
+                    vector<eid> reads)
 {
-  tear_down(g, p.first);
-  tear_down(g, p.second);
+  sort(reads.begin(), reads.end());
+  reads.erase(unique(reads.begin(), reads.end()), reads.end());
+
+  cached_t &c = m_cached[d];
+  c.m_cu = cu;
+  c.m_p = p;
+  c.m_reads = std::move(reads);
+  c.m_clock = m_occ.clock();
+}
+
+bool
+routing::get_learned(const graph &g, const demand &d, const CU &cu,
+                     optional<cupp> &lp,
+                     pair<array<unsigned long, 5>, optional<cupp>> &p)
+{
+  lp = m_learned.fit(g, m_edges, d, cu);
+  stats::get().learn_perf(lp.has_value());
+
+  if (lp)
+    ++m_fits;
+
+  // The fit is used, unless it is checked.
+  bool used = lp && !(m_verify && m_fits % m_verify == 0);
+  if (used)
+    p = make_pair(array<unsigned long, 5>{0, 0, 0, 0, 0}, lp);
+
+  m_exact = !used;
+
+  return used;
+}
+
+void
+routing::put_learned(const graph &g, const demand &d,
+                     const optional<cupp> &lp, const optional<cupp> &p)
+{
+  if (lp)
+    stats::get().learn_check(p, lp);
+
+  if (p)
+    m_learned.learn(g, d, p.value());
+}
+
+bool
+routing::prepass(const graph &g, const demand &d)
+{
+  auto t0 = chrono::steady_clock::now();
+  bool feasible = is_feasible(g, d, feasible_edges(g, d));
+  auto t1 = chrono::steady_clock::now();
+  chrono::duration<double> dt = t1 - t0;
+
+  stats::get().prepass_perf(dt.count(), feasible);
+
+  if (!feasible)
+    for (rt_t rt: m_algs)
+      stats::get().algo_perf(rt, dt.count(), d,
+                             make_pair(array<unsigned long, 5>{},
+                                       optional<cupp>()));
+
+  return feasible;
+}
+
+void
+routing::tear_down(graph &g, const CU &cu, const eid *first,
+                   const eid *last)
+{
+  boost::property_map<graph, boost::edge_su_t>::type
+    sm = get(boost::edge_su_t(), g);
+
+  // Iterate over the edges of the path.
+  for(; first != last; ++first)
+    {
+      eid i = *first;
+      const edge &e = m_edges[i];
+      sm[e].insert(cu);
+      m_occ.give(i, cu);
+      assert(m_occ.free_units(i) == sm[e].count());
+      assert(m_occ.frags(i) == sm[e].size());
+    }
 }
 
 void
@@ -159,7 +557,13 @@ routing::set_up(graph &g, const cupath &p)
     sm = get(boost::edge_su_t(), g);
 
   for(const auto &e: p.second)
-    sm[e].remove(p.first);
+    {
+      sm[e].remove(p.first);
+      unsigned i = boost::get(boost::edge_index, g, e);
+      m_occ.take(i, p.first);
+      assert(m_occ.free_units(i) == sm[e].count());
+      assert(m_occ.frags(i) == sm[e].size());
+    }
 }
 
 void
@@ -174,8 +578,11 @@ routing::to_string(rt_t rt)
 {
   static const map<rt_t, string> t2s
   {{rt_t::gd, "gd"},
+   {rt_t::gdb, "gdb"},
    {rt_t::bf, "bf"},
-   {rt_t::ee, "ee"}};
+   {rt_t::ee, "ee"},
+   {rt_t::ksp, "ksp"},
+   {rt_t::sw, "sw"}};
   auto i = t2s.find(rt);
   assert(i != t2s.end());
   return i->second;
@@ -186,3 +593,87 @@ routing::add_algorithm(const rt_t rt)
 {
   m_algs.insert(rt);
 }
+
+void
+routing::set_budget(unsigned long labels, double time)
+{
+  m_budget.m_labels = labels;
+  m_budget.m_time = time;
+}
+
+void
+routing::set_prepass(bool prepass)
+{
+  m_prepass = prepass;
+}
+
+void
+routing::set_beam(unsigned beam)
+{
+  m_beam = beam;
+}
+
+void
+routing::set_gd_threads(unsigned threads)
+{
+  m_budget.m_threads = threads;
+}
+
+void
+routing::set_cache(bool cache)
+{
+  m_cache = cache;
+}
+
+void
+routing::set_incremental(bool incremental)
+{
+  m_incremental = incremental;
+}
+
+void
+routing::set_learn(unsigned capacity, unsigned verify)
+{
+  m_learn = capacity;
+  m_verify = verify;
+}
+
+void
+routing::set_threads(unsigned threads)
+{
+  m_threads = threads;
+}
+
+void
+routing::set_ksp(unsigned k)
+{
+  m_ksp = k;
+}
+
+void
+routing::init(const graph &g)
+{
+  m_occ.reset(g);
+  m_dists.reset(g);
+  m_states.assign(num_vertices(g), gd_state());
+  m_cached.clear();
+  m_learned.reset(m_learn);
+  m_fits = 0;
+
+  if (m_ksp)
+    m_ksp_table.build(g, m_ksp, m_threads);
+
+  m_edges = get_edges(g);
+}
+
+const occupancy &
+routing::get_occupancy()
+{
+  return m_occ;
+}
+
+const edge &
+routing::get_edge(eid i)
+{
+  return m_edges[i];
+}
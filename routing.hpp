@@ -1,19 +1,30 @@
 #ifndef ROUTING_HPP
 #define ROUTING_HPP
 
+#include "dist_table.hpp"
+#include "gd.hpp"
 #include "graph.hpp"
+#include "ksp.hpp"
+#include "occupancy.hpp"
+#include "pair_cache.hpp"
 #include "sim.hpp"
 
+#include <deque>
+#include <map>
 #include <optional>
+#include <vector>
 
 class routing: public sim
 {  
 public:
   // The routing algorithm:
   // gd - generic Dijkstra
+  // gdb - generic Dijkstra with the beam
   // bf - brute force
   // ee - edge exclusion
-  enum class rt_t {gd, bf, ee};
+  // ksp - k shortest path pairs
+  // sw - slot window
+  enum class rt_t {gd, gdb, bf, ee, ksp, sw};
 
   // Return the string of the routing type.
   static std::string
@@ -35,19 +46,96 @@ public:
   static std::optional<cupp>
   search(graph &g, const demand &d, const CU &cu, rt_t rt);
 
-  // Tear down the cupath in the graph.  This process puts back the
-  // units on the edges that are used by the path.
+  // Tear down the path of the given CU and edge IDs [first, last) in
+  // the graph.  This process puts back the units on the edges that
+  // are used by the path.
   static void
-  tear_down(graph &g, const cupath &p);
-
-  // Tear down the cupp in the graph.  This process puts back the
-  // units on the edges that are used by the path pair.
-  static void
-  tear_down(graph &g, const cupp &p);
+  tear_down(graph &g, const CU &cu, const eid *first, const eid *last);
 
   // What a routing algorithm to run.
   static void add_algorithm(const rt_t rt);
 
+  // Set the budget of the generic Dijkstra search: the max number of
+  // labels made permanent, and the max search time in seconds, 0 for
+  // no limit.  When the budget is exceeded, the best path pair found
+  // so far is used, or the edge exclusion search is run.
+  static void
+  set_budget(unsigned long labels, double time);
+
+  // Enable the feasibility pre-pass, which blocks a demand before any
+  // search, if the demand cannot be set up.
+  static void
+  set_prepass(bool prepass);
+
+  // Set the beam of the generic Dijkstra search with the beam, i.e.,
+  // the max number of labels per vertex pair.
+  static void
+  set_beam(unsigned beam);
+
+  // Set the number of threads of a generic Dijkstra search, which
+  // expands the labels of similar cost in parallel.
+  static void
+  set_gd_threads(unsigned threads);
+
+  // Enable the incremental generic Dijkstra search, which keeps the
+  // state of the last search from every source, and repairs it, when
+  // the next search from the source is for the same demand.
+  static void
+  set_incremental(bool incremental);
+
+  // Enable the cache of the generic Dijkstra results, which returns
+  // the result of the last search for the same demand and CU, if the
+  // edges read by the search have not changed since.
+  static void
+  set_cache(bool cache);
+
+  // Enable the cache of the path pairs learned from the generic
+  // Dijkstra results, with the given number of path pairs per node
+  // pair.  A demand is fit into the learned path pairs first, and the
+  // search is run only when none fits, or for every verify-th fit, 0
+  // for none, to check the fit against the exact result.
+  static void
+  set_learn(unsigned capacity, unsigned verify);
+
+  // Set the number of threads of the speculative searches.
+  static void
+  set_threads(unsigned threads);
+
+  // Set the number of the candidate path pairs per node pair of the
+  // k shortest path pairs search.  The table of the candidates is
+  // built by init with the number of threads of the speculative
+  // searches.
+  static void
+  set_ksp(unsigned k);
+
+  // Run in parallel the searches for the demands, which are expected
+  // to be set up next in this order, against the current state of the
+  // network.  The results are used by the next calls of set_up, if
+  // the edges read by a search have not changed in the meantime,
+  // otherwise the search is run again.  Only the generic Dijkstra
+  // search is run speculatively.
+  static void
+  speculate(const graph &g, const std::vector<demand> &ds);
+
+  // True if there are speculative results not used yet.
+  static bool
+  has_speculations();
+
+  // Initialize the spectrum occupancy with the current state of the
+  // graph, the table of the edge descriptors, the table of the
+  // shortest distances, and the table of the candidate path pairs.
+  // Call it after the units are set on the graph.
+  static void
+  init(const graph &g);
+
+  // The spectrum occupancy of the network.
+  static const occupancy &
+  get_occupancy();
+
+  // The descriptor of the edge of the given ID.
+  static const edge &
+  get_edge(eid i);
+
 protected:
   // Set up the given cupath.  This process takes the units on the
   // edges that are used by the path.  The function always succeeds,
@@ -61,8 +149,137 @@ protected:
   static void
   set_up(graph &g, const cupp &p);
 
+  // Run the feasibility pre-pass for the demand.  If the demand is
+  // infeasible, it is reported as blocked for every routing algorithm,
+  // and false is returned.
+  static bool
+  prepass(const graph &g, const demand &d);
+
+  // The speculative search.
+  struct spec_t
+  {
+    // The demand.
+    demand m_d;
+    // The result of the search.
+    std::pair<std::array<unsigned long, 5>, std::optional<cupp>> m_p;
+    // The sorted indexes of the edges read by the search.
+    std::vector<eid> m_reads;
+    // The search time.
+    double m_dt;
+  };
+
+  // The cached result of the generic Dijkstra search.
+  struct cached_t
+  {
+    // The CU searched.
+    CU m_cu;
+    // The result of the search.
+    std::pair<std::array<unsigned long, 5>, std::optional<cupp>> m_p;
+    // The sorted indexes of the edges read by the search.
+    std::vector<eid> m_reads;
+    // The occupancy clock when the search was run.
+    unsigned long m_clock;
+  };
+
+  // Get the cached result for the demand and CU into p, and return
+  // true, if the result is valid.
+  static bool
+  get_cached(const demand &d, const CU &cu,
+             std::pair<std::array<unsigned long, 5>,
+                       std::optional<cupp>> &p);
+
+  // Cache the result of the search for the demand and CU, which read
+  // the edges of the given indexes, possibly with repetitions.
+  static void
+  put_cached(const demand &d, const CU &cu,
+             const std::pair<std::array<unsigned long, 5>,
+                             std::optional<cupp>> &p,
+             std::vector<eid> reads);
+
+  // The CU searched for the demand: all units of the src edges.
+  static CU
+  get_cu(const graph &g, const demand &d);
+
+  // Fit the demand into the learned path pairs, and put the fit into
+  // lp.  Return true if the fit is used as the result p, and so the
+  // search is not run, which is then inexact.
+  static bool
+  get_learned(const graph &g, const demand &d, const CU &cu,
+              std::optional<cupp> &lp,
+              std::pair<std::array<unsigned long, 5>,
+                        std::optional<cupp>> &p);
+
+  // Report the fit lp into the learned path pairs, which was not used,
+  // against the exact result p of the search, and learn p.
+  static void
+  put_learned(const graph &g, const demand &d,
+              const std::optional<cupp> &lp, const std::optional<cupp> &p);
+
+  // Return the speculative result for the demand if it's still valid.
+  // The speculative result for the demand is consumed.
+  static std::optional<spec_t>
+  take_speculation(const demand &d);
+
   // What routing algorithms to use.
   static std::set<rt_t> m_algs;
+
+  // True if the feasibility pre-pass is enabled.
+  static bool m_prepass;
+
+  // The spectrum occupancy kept along with the SUs of the edges.
+  static occupancy m_occ;
+
+  // The edge descriptors indexed with the edge ID.
+  static std::vector<edge> m_edges;
+
+  // The shortest distances to the destinations, which are used to
+  // prune the labels of the searches.
+  static dist_table m_dists;
+
+  // The budget of the generic Dijkstra search.
+  static gd_budget m_budget;
+
+  // The beam of the generic Dijkstra search with the beam.
+  static unsigned m_beam;
+
+  // True if the result of the last search is exact.
+  static bool m_exact;
+
+  // The number of threads of the speculative searches.
+  static unsigned m_threads;
+
+  // True if the cache of the generic Dijkstra results is enabled.
+  static bool m_cache;
+
+  // The cached results indexed with the demand.
+  static std::map<demand, cached_t> m_cached;
+
+  // True if the incremental generic Dijkstra search is enabled.
+  static bool m_incremental;
+
+  // The states of the last searches indexed with the source, and the
+  // occupancy clock when they were run.
+  static std::vector<gd_state> m_states;
+
+  // The number of the path pairs learned per node pair, 0 if the
+  // cache is disabled, and the cache.
+  static unsigned m_learn;
+  static pair_cache m_learned;
+
+  // Every verify-th fit into the learned path pairs is checked, 0 for
+  // none, and the number of the fits.
+  static unsigned m_verify;
+  static unsigned long m_fits;
+
+  // The number of the candidate path pairs per node pair, and their
+  // table.
+  static unsigned m_ksp;
+  static ksp_table m_ksp_table;
+
+  // The speculative searches not used yet, in the order of the
+  // demands, and the occupancy clock when they were run.
+  static std::deque<spec_t> m_specs;
+  static unsigned long m_spec_clock;
 };
 
 #endif /* ROUTING_HPP */
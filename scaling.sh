@@ -0,0 +1,72 @@
+#!/bin/bash
+
+# The scaling study of the searches: generate the networks with
+# netgen, and run ddpp_bench for them.  A CSV line is printed for
+# every network and number of units, with the time and the number of
+# labels per search, and the maximal resident set size of ddpp_bench
+# in kB, if /usr/bin/time is available.
+#
+# The parameters can be changed with the environment variables, e.g.:
+#
+# MODELS="waxman ba" NODES="100 1000 10000" ./scaling.sh
+
+MODELS=${MODELS:-"waxman grid torus ba rings"}
+NODES=${NODES:-"100 200 500 1000 2000"}
+DEGREES=${DEGREES:-"3 4"}
+UNITS=${UNITS:-"40 80 160"}
+SEEDS=${SEEDS:-"1"}
+NDEMANDS=${NDEMANDS:-100}
+MNU=${MNU:-4}
+REPS=${REPS:-3}
+ALGS=${ALGS:-"--gd"}
+
+DIR=$(dirname "$0")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ -x /usr/bin/time ]; then
+    TIME="/usr/bin/time -f %M -o $TMP/rss"
+fi
+
+# Print the value of the JSON field.
+field()
+{
+    grep "\"$1\"" "$TMP/out" | head -1 | sed 's/.*: *\([^,]*\),*/\1/'
+}
+
+echo "model,nodes,degree,seed,edges,units,ns_per_search,labels_per_search,allocs_per_search,found,max_rss_kb"
+
+for model in $MODELS; do
+    for nodes in $NODES; do
+        for degree in $DEGREES; do
+            for seed in $SEEDS; do
+                net="$TMP/net.dot"
+                dem="$TMP/demands.txt"
+
+                if ! "$DIR/netgen" --model $model --nodes $nodes \
+                     --degree $degree --seed $seed --output "$net" \
+                     --demands "$dem" --ndemands $NDEMANDS --mnu $MNU \
+                     2> /dev/null; then
+                    echo "Failed: netgen --model $model --nodes $nodes" >&2
+                    continue
+                fi
+
+                edges=$(grep -c -- "--" "$net")
+
+                for units in $UNITS; do
+                    if ! $TIME "$DIR/ddpp_bench" --net "$net" \
+                         --units $units --demands "$dem" \
+                         --reps $REPS $ALGS > "$TMP/out"; then
+                        echo "Failed: ddpp_bench for $model $nodes" >&2
+                        continue
+                    fi
+
+                    rss=""
+                    [ -n "$TIME" ] && rss=$(tail -1 "$TMP/rss")
+
+                    echo "$model,$nodes,$degree,$seed,$edges,$units,$(field ns_per_search),$(field labels_per_search),$(field allocs_per_search),$(field found),$rss"
+                done
+            done
+        done
+    done
+done
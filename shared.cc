@@ -6,39 +6,46 @@
 
 using namespace std;
 
+// The other end of edge e than vertex v.
+static vertex
+other(const graph &g, const edge &e, vertex v)
+{
+  vertex s = source(e, g);
+  return s == v ? target(e, g) : s;
+}
+
 std::optional<std::pair<cupath, cupath> >
-trace(const graph &g, const tn_t &tn, const unsigned &ncu)
+trace(const graph &g, const std::vector<edge> &es, const search_tree &tree,
+      tni_t i, const unsigned &ncu)
 {
   std::optional<std::pair<cupath, cupath> > result;
   
   optional<cupath> p1, p2;
   optional<COST> c1, c2;
+  // The first vertexes of p1 and p2.  The descriptors of the edge
+  // table have the direction of the graph, not of the paths.
+  vertex s1, s2;
 
-  // Trace back the paths.  We start at the current tree node, i.e.,
-  // tnp, and end at the root (which has nullptr as the parent node).
+  // Trace back the paths.  We start at the current tree node i, and
+  // end at the root (which has no_tni as the parent index).
   // In every iteration we put an edge into either p1 or p2.
-  for(const tn_t *ptr = &tn; std::get<4>(*ptr).get() != nullptr;
-      ptr = std::get<4>(*ptr).get())
+  for(; tree[i].m_parent != no_tni; i = tree[i].m_parent)
     {
       // Here we're processing the tree node tn.
-      const tn_t tn = *ptr;
-      // The edge of tn.  We need to put it into p1 or p2.
-      const edge &e = std::get<2>(tn);
-      // This is the new vertex in the vertex pair.
-      const vertex &t = boost::target(e, g);
+      const tn_t &tn = tree[i];
 
       // If true, the first label is new.
-      bool first = std::get<3>(tn);
+      bool first = tn.m_first;
 
       // The vertex pair of the tn.
-      const vertex_pair_t tnvp = std::get<0>(tn);
-      // Let's make sure that the target of the edge is the right
-      // vertex (either first or second) in the vertex pair of the
-      // tree node.
-      assert((first ? tnvp.first : tnvp.second) == t);
+      const vertex_pair_t tnvp = tree.vp(i);
+      // This is the new vertex in the vertex pair.
+      const vertex t = first ? tnvp.first : tnvp.second;
+      // The edge of tn.  We need to put it into p1 or p2.
+      const edge &e = es[tn.m_e];
 
       // The label pair of the tree node we're processing.
-      const label_pair_t &l = std::get<1>(tn);
+      const label_pair_t l = tree.lp(i);
       // This is the 1st label of tn.
       const label &tnl1 = l.first;
       // This is the 2nd label of tn.
@@ -55,8 +62,7 @@ trace(const graph &g, const tn_t &tn, const unsigned &ncu)
           // The cu of path p1.
           const auto &pcu = p1.value().first;
 
-          if (t == source(pe, g) && nl_cu.includes(pcu) &&
-              nc + pec == c1.value())
+          if (t == s1 && nl_cu.includes(pcu) && nc + pec == c1.value())
             {
               bool yeah = true;
 
@@ -108,6 +114,7 @@ trace(const graph &g, const tn_t &tn, const unsigned &ncu)
                 {
                   p1.value().second.push_front(e);
                   c1 = nc;
+                  s1 = other(g, e, t);
                   continue;
                 }
             }
@@ -122,11 +129,11 @@ trace(const graph &g, const tn_t &tn, const unsigned &ncu)
           // The cu of path p2.
           const auto &pcu = p2.value().first;
 
-          if (t == source(pe, g) && nl_cu.includes(pcu) &&
-              nc + pec == c2.value())
+          if (t == s2 && nl_cu.includes(pcu) && nc + pec == c2.value())
             {
               p2.value().second.push_front(e);
               c2 = nc;
+              s2 = other(g, e, t);
               continue;
             }
         }
@@ -138,6 +145,8 @@ trace(const graph &g, const tn_t &tn, const unsigned &ncu)
       optional<cupath> &op = p1 ? p2 : p1;
       // And optional cost.
       optional<COST> &oc = p1 ? c2 : c1;
+      // And the first vertex.
+      vertex &os = p1 ? s2 : s1;
       // Make sure we chose the optional with no value.
       assert(op == nullopt);
 
@@ -145,6 +154,7 @@ trace(const graph &g, const tn_t &tn, const unsigned &ncu)
       // First-fit spectrum allocation policy.
       op.emplace(CU(nl_cu.min(), nl_cu.min() + units), path{e});
       oc = nc;
+      os = other(g, e, t);
     }
 
   if (get_cost(g, p1.value()) <= get_cost(g, p2.value()))
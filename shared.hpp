@@ -3,27 +3,166 @@
 
 #include "label.hpp"
 
-#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <limits>
 #include <optional>
-#include <queue>
+#include <vector>
 
-// Tree node type declared.
-struct tn_t;
+// The edge ID of the root tree node, which has no edge.
+constexpr eid no_eid = std::numeric_limits<eid>::max();
 
-// Tree node type defined.
-struct tn_t: std::tuple<vertex_pair_t, label_pair_t,
-                        edge, bool, std::shared_ptr<tn_t> >
-{
-  using base = std::tuple<vertex_pair_t, label_pair_t,
-                          edge, bool, std::shared_ptr<tn_t> >;
+// The index of a tree node.
+using tni_t = std::uint32_t;
+
+// The parent index of the root tree node.
+constexpr tni_t no_tni = std::numeric_limits<tni_t>::max();
 
-  using base::base;
+// The tree node: the vertex pair, the CUs of the label pair, and the
+// ID of the edge which reached the new vertex of the vertex pair.  The
+// costs of the labels are kept apart by the search tree.
+struct tn_t
+{
+  // The vertex pair.
+  std::uint32_t m_v1;
+  std::uint32_t m_v2;
+  // The CUs of the first and the second label.
+  std::uint16_t m_min1;
+  std::uint16_t m_max1;
+  std::uint16_t m_min2;
+  std::uint16_t m_max2;
+  // The edge ID.
+  eid m_e;
+  // The index of the parent, no_tni for the root.
+  tni_t m_parent;
+  // True if the first label is new, i.e., the label pair was swapped.
+  bool m_first;
+  // True if the tentative label was discarded.
+  bool m_discarded;
 };
 
-// The tnt shared_ptr.
-using tnsp_t = std::shared_ptr<tn_t>;
+static_assert(sizeof(tn_t) <= 28);
+
+// The search tree: the tree nodes, and the costs of their labels in
+// two arrays of the same index, so that the dominance checks, which
+// mostly compare the costs, read contiguous memory.  The nodes are
+// never removed, but marked as discarded.
+class search_tree
+{
+  std::vector<tn_t> m_nodes;
+  std::vector<COST> m_c1;
+  std::vector<COST> m_c2;
+
+public:
+  // Add the tree node, and return its index.  The units of the CUs
+  // have to fit in 16 bits.
+  tni_t
+  add(const vertex_pair_t &vp, const label_pair_t &lp, eid e,
+      bool first, tni_t parent)
+  {
+    const CU &cu1 = lp.first.second;
+    const CU &cu2 = lp.second.second;
+    assert(cu1.max() <= std::numeric_limits<std::uint16_t>::max());
+    assert(cu2.max() <= std::numeric_limits<std::uint16_t>::max());
+    assert(m_nodes.size() < no_tni);
+
+    m_nodes.push_back({std::uint32_t(vp.first), std::uint32_t(vp.second),
+                       std::uint16_t(cu1.min()), std::uint16_t(cu1.max()),
+                       std::uint16_t(cu2.min()), std::uint16_t(cu2.max()),
+                       e, parent, first, false});
+    m_c1.push_back(lp.first.first);
+    m_c2.push_back(lp.second.first);
+
+    return m_nodes.size() - 1;
+  }
+
+  const tn_t &
+  operator[](tni_t i) const
+  {
+    return m_nodes[i];
+  }
+
+  tn_t &
+  operator[](tni_t i)
+  {
+    return m_nodes[i];
+  }
+
+  vertex_pair_t
+  vp(tni_t i) const
+  {
+    return vertex_pair_t(m_nodes[i].m_v1, m_nodes[i].m_v2);
+  }
+
+  label_pair_t
+  lp(tni_t i) const
+  {
+    const tn_t &n = m_nodes[i];
+    return label_pair_t(label(m_c1[i], CU(n.m_min1, n.m_max1)),
+                        label(m_c2[i], CU(n.m_min2, n.m_max2)));
+  }
+
+  // True if the label pair of node i is better than or equal to j.
+  bool
+  better_or_equal(tni_t i, const label_pair_t &j) const
+  {
+    if (!(m_c1[i] <= j.first.first && m_c2[i] <= j.second.first))
+      return false;
+
+    const tn_t &n = m_nodes[i];
+    return n.m_min1 <= j.first.second.min() &&
+      j.first.second.max() <= n.m_max1 &&
+      n.m_min2 <= j.second.second.min() &&
+      j.second.second.max() <= n.m_max2;
+  }
+
+  // True if the label pair of node i is worse than or equal to j.
+  bool
+  worse_or_equal(tni_t i, const label_pair_t &j) const
+  {
+    if (!(j.first.first <= m_c1[i] && j.second.first <= m_c2[i]))
+      return false;
+
+    const tn_t &n = m_nodes[i];
+    return j.first.second.min() <= n.m_min1 &&
+      n.m_max1 <= j.first.second.max() &&
+      j.second.second.min() <= n.m_min2 &&
+      n.m_max2 <= j.second.second.max();
+  }
+
+  // True if edge e is used on the way from node i to the root.
+  bool
+  uses(tni_t i, eid e) const
+  {
+    for(; i != no_tni; i = m_nodes[i].m_parent)
+      if (m_nodes[i].m_e == e)
+        return true;
+
+    return false;
+  }
+
+  // Remove the nodes from node n on.
+  void
+  truncate(std::size_t n)
+  {
+    assert(n <= m_nodes.size());
+    m_nodes.resize(n);
+    m_c1.resize(n);
+    m_c2.resize(n);
+  }
+
+  // The number of nodes.
+  std::size_t
+  size() const
+  {
+    return m_nodes.size();
+  }
+};
 
+// Trace back the path pair from tree node i to the root.  The edge
+// descriptors es are indexed with the edge ID.
 std::optional<std::pair<cupath, cupath> >
-trace(const graph &g, const tn_t &tn, const unsigned &);
+trace(const graph &g, const std::vector<edge> &es, const search_tree &t,
+      tni_t i, const unsigned &);
 
 #endif // SHARED_HPP
@@ -1,13 +1,23 @@
 #ifndef SIM_HPP
 #define SIM_HPP
 
-#include "simulation.hpp"
 #include "graph.hpp"
 #include "module.hpp"
 
 #include <random>
 
+// The simulation uses the calendar queue of calendar_simulation.hpp
+// as the event list, unless DES_EVENT_QUEUE is defined, in which case
+// the simulation of the des library is used.
+#ifdef DES_EVENT_QUEUE
+#include "simulation.hpp"
 typedef simulation<double, graph, std::default_random_engine> sim;
+#else
+#include "calendar_simulation.hpp"
+typedef calendar_simulation<double, graph, std::default_random_engine>
+sim;
+#endif
+
 typedef module<sim> mod;
 
 #endif /* SIM_HPP */
@@ -0,0 +1,241 @@
+#include "snapshot.hpp"
+
+#include <boost/range.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+// The magic string at the start of a snapshot file.
+static const char magic[] = "DDPPSS1\n";
+
+// The size of the magic string without the terminating null.
+static constexpr size_t magic_size = sizeof(magic) - 1;
+
+// Write the unsigned integer as LEB128.
+static void
+put(ostream &os, uint64_t v)
+{
+  do
+    {
+      unsigned char b = v & 0x7f;
+      v >>= 7;
+      if (v)
+        b |= 0x80;
+      os.put(b);
+    }
+  while (v);
+}
+
+// Read the unsigned integer written as LEB128.
+static bool
+get(istream &is, uint64_t &v)
+{
+  v = 0;
+
+  for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+      char c;
+      if (!is.get(c))
+        return false;
+
+      unsigned char b = c;
+      v |= uint64_t(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return true;
+    }
+
+  return false;
+}
+
+static void
+put_double(ostream &os, double v)
+{
+  os.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static bool
+get_double(istream &is, double &v)
+{
+  return static_cast<bool>(is.read(reinterpret_cast<char *>(&v),
+                                   sizeof(v)));
+}
+
+// The edges indexed with the edge index.
+static vector<edge>
+edges_by_index(const graph &g)
+{
+  vector<edge> result(num_edges(g));
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    result[boost::get(boost::edge_index, g, e)] = e;
+
+  return result;
+}
+
+snapshot
+take_snapshot(const graph &g, double t)
+{
+  snapshot s;
+  s.m_t = t;
+  s.m_sus.resize(num_edges(g));
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    s.m_sus[boost::get(boost::edge_index, g, e)] =
+      boost::get(boost::edge_su, g, e);
+
+  return s;
+}
+
+void
+restore_snapshot(graph &g, const snapshot &s)
+{
+  assert(s.m_sus.size() == num_edges(g));
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    boost::get(boost::edge_su, g)[e] =
+      s.m_sus[boost::get(boost::edge_index, g, e)];
+}
+
+// Write the path as the number of edges and the edge indexes.
+static void
+put(ostream &os, const graph &g, const cupath &p)
+{
+  put(os, p.first.min());
+  put(os, p.first.count());
+  put(os, p.second.size());
+
+  for (const auto &e: p.second)
+    put(os, boost::get(boost::edge_index, g, e));
+}
+
+static bool
+get(istream &is, const vector<edge> &es, cupath &p)
+{
+  uint64_t min, count, n;
+
+  if (!get(is, min) || !get(is, count) || !count || !get(is, n))
+    return false;
+
+  p.first = CU(min, min + count);
+  p.second.clear();
+
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      uint64_t ei;
+      if (!get(is, ei) || ei >= es.size())
+        return false;
+      p.second.push_back(es[ei]);
+    }
+
+  return true;
+}
+
+bool
+save_snapshot(const string &file_name, const graph &g,
+              const snapshot &s)
+{
+  ofstream os(file_name, ios::binary);
+
+  if (!os)
+    {
+      cerr << "Error opening a snapshot file '" << file_name << "'.\n";
+      return false;
+    }
+
+  os.write(magic, magic_size);
+  put_double(os, s.m_t);
+
+  put(os, s.m_sus.size());
+  for (const auto &su: s.m_sus)
+    {
+      put(os, su.size());
+      for (const auto &cu: su)
+        {
+          put(os, cu.min());
+          put(os, cu.count());
+        }
+    }
+
+  put(os, s.m_conns.size());
+  for (const auto &c: s.m_conns)
+    {
+      put(os, c.m_d.first.first);
+      put(os, c.m_d.first.second);
+      put(os, c.m_d.second);
+      put_double(os, c.m_tdt);
+      put(os, g, c.m_p.first);
+      put(os, g, c.m_p.second);
+    }
+
+  return static_cast<bool>(os);
+}
+
+bool
+load_snapshot(const string &file_name, const graph &g, snapshot &s)
+{
+  ifstream is(file_name, ios::binary);
+
+  if (!is)
+    {
+      cerr << "Error opening a snapshot file '" << file_name << "'.\n";
+      return false;
+    }
+
+  auto error = [&file_name]()
+               {
+                 cerr << "Error reading a snapshot file '"
+                      << file_name << "'.\n";
+                 return false;
+               };
+
+  char buf[magic_size];
+  if (!is.read(buf, magic_size) || memcmp(buf, magic, magic_size))
+    return error();
+
+  s = snapshot();
+
+  uint64_t ne;
+  if (!get_double(is, s.m_t) || !get(is, ne) || ne != num_edges(g))
+    return error();
+
+  s.m_sus.resize(ne);
+  for (auto &su: s.m_sus)
+    {
+      uint64_t n;
+      if (!get(is, n))
+        return error();
+
+      for (uint64_t i = 0; i < n; ++i)
+        {
+          uint64_t min, count;
+          if (!get(is, min) || !get(is, count) || !count)
+            return error();
+          su.insert(CU(min, min + count));
+        }
+    }
+
+  const vector<edge> es = edges_by_index(g);
+
+  uint64_t nc;
+  if (!get(is, nc))
+    return error();
+
+  s.m_conns.resize(nc);
+  for (auto &c: s.m_conns)
+    {
+      uint64_t src, dst, ncu;
+      if (!get(is, src) || !get(is, dst) || !get(is, ncu) ||
+          src >= num_vertices(g) || dst >= num_vertices(g) ||
+          !get_double(is, c.m_tdt) || !get(is, es, c.m_p.first) ||
+          !get(is, es, c.m_p.second))
+        return error();
+
+      c.m_d = demand(npair(src, dst), ncu);
+    }
+
+  return true;
+}
@@ -0,0 +1,61 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "graph.hpp"
+#include "units.hpp"
+
+#include <string>
+#include <vector>
+
+// The snapshot of the network state: the SUs of the edges, and
+// optionally the connections established.
+struct snapshot
+{
+  // An established connection.
+  struct conn_t
+  {
+    // The demand.
+    demand m_d;
+    // The path pair.
+    cupp m_p;
+    // The tear down time.
+    double m_tdt;
+  };
+
+  // The simulation time of the snapshot.
+  double m_t = 0;
+
+  // The SUs of the edges, indexed with the edge index.
+  std::vector<SU> m_sus;
+
+  // The connections.
+  std::vector<conn_t> m_conns;
+};
+
+// Take the snapshot of the SUs of the edges at time t.  The
+// connections are not included.
+snapshot
+take_snapshot(const graph &g, double t);
+
+// Restore the SUs of the snapshot in the graph.  The graph should be
+// loaded, and have the units set.  The connections are not restored.
+void
+restore_snapshot(graph &g, const snapshot &s);
+
+// Save the snapshot to the file.  The file is binary.  It starts
+// with the magic string, and the time.  Then there are the SUs of the
+// edges in the order of the edge index, every SU as the number of
+// CUs, and the min and the count of every CU.  Then there are the
+// connections, every as the end nodes, the number of units, the tear
+// down time, and the CU and the edge indexes of both paths.  The
+// integers are written as the variable-length LEB128.
+bool
+save_snapshot(const std::string &file_name, const graph &g,
+              const snapshot &s);
+
+// Load the snapshot from the file for the graph.
+bool
+load_snapshot(const std::string &file_name, const graph &g,
+              snapshot &s);
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,30 @@
+#include "snapshot_taker.hpp"
+
+#include "client.hpp"
+#include "snapshot.hpp"
+#include "traffic.hpp"
+
+using namespace std;
+
+snapshot_taker::snapshot_taker(const string &file_name, double t,
+                               const traffic &tra):
+  m_file_name(file_name), m_tra(tra)
+{
+  schedule(t);
+}
+
+void
+snapshot_taker::operator()(double t)
+{
+  snapshot s = take_snapshot(m_mdl, t);
+
+  m_tra.for_each_client([&s](const client &c)
+                        {
+                          const connection &conn = c.get_connection();
+                          s.m_conns.push_back({conn.get_demand(),
+                                               conn.get_cupp(),
+                                               c.get_tdt()});
+                        });
+
+  save_snapshot(m_file_name, m_mdl, s);
+}
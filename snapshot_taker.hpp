@@ -0,0 +1,29 @@
+#ifndef SNAPSHOT_TAKER_HPP
+#define SNAPSHOT_TAKER_HPP
+
+#include "module.hpp"
+#include "sim.hpp"
+
+#include <string>
+
+class traffic;
+
+// The module which saves the snapshot of the network state and the
+// connections at the given simulation time.
+class snapshot_taker: public module<sim>
+{
+  // The file name.
+  const std::string m_file_name;
+
+  // The traffic of the run.
+  const traffic &m_tra;
+
+public:
+  snapshot_taker(const std::string &file_name, double t,
+                 const traffic &tra);
+
+  void
+  operator()(double t);
+};
+
+#endif // SNAPSHOT_TAKER_HPP
@@ -15,12 +15,34 @@ using namespace std;
 stats *stats::singleton;
 
 stats::stats(const cli_args &args, const traffic &tra):
-  m_args(args), m_tra(tra),
-  m_dt((args.sim_time - args.kickoff) / nom)
+  m_tra(tra), m_args(args),
+  m_dt((args.sim_time - args.kickoff) / args.samples)
 {
   assert(!singleton);
   singleton = this;
 
+  m_hops = calc_sp_hops(m_mdl);
+
+  if (!args.stream.empty())
+    {
+      // The algorithms we report on in the stream.
+      if (args.gd)
+        m_int[routing::rt_t::gd];
+      if (args.gdb)
+        m_int[routing::rt_t::gdb];
+      if (args.bf)
+        m_int[routing::rt_t::bf];
+      if (args.ee)
+        m_int[routing::rt_t::ee];
+      if (args.ksp)
+        m_int[routing::rt_t::ksp];
+      if (args.sw)
+        m_int[routing::rt_t::sw];
+
+      m_stream = make_unique<async_writer>(args.stream);
+      stream_header();
+    }
+
   // We start collecting the utilization stats at the kickoff time.
   schedule(args.kickoff);
 }
@@ -32,6 +54,37 @@ output(const string &txt, const T &v)
   cout << txt << " " << v << endl;
 }
 
+// The time in seconds of a value in nanoseconds.
+static double
+seconds(unsigned long ns)
+{
+  return ns / 1e9;
+}
+
+// Output the percentiles of the search time.
+static void
+output_percentiles(const string &prefix, const histogram &h)
+{
+  output(prefix + "p50_time", seconds(h.quantile(0.5)));
+  output(prefix + "p90_time", seconds(h.quantile(0.9)));
+  output(prefix + "p99_time", seconds(h.quantile(0.99)));
+  output(prefix + "p999_time", seconds(h.quantile(0.999)));
+}
+
+// Output the statistics of the search time for the classes of
+// searches.
+static void
+output_classes(const string &prefix, const map<int, histogram> &m)
+{
+  for (const auto &[k, h]: m)
+    {
+      const string cp = prefix + std::to_string(k) + '_';
+      output(cp + "searches", h.count());
+      output_percentiles(cp, h);
+      output(cp + "max_time", seconds(h.max()));
+    }
+}
+
 stats::~stats()
 {
   // The population name.
@@ -60,6 +113,7 @@ stats::~stats()
 
       output(prefix + "mean_time", ba::mean(m_t[rt]));
       output(prefix + "max_time", ba::max(m_t[rt]));
+      output_percentiles(prefix, m_th[rt].m_all);
       output(prefix + "mean_mmwu", ba::mean(m_mmwus[rt]));
       output(prefix + "max_mmwu", ba::max(m_mmwus[rt]));
       output(prefix + "mean_mpqc", ba::mean(m_mpqcs[rt]));
@@ -68,6 +122,65 @@ stats::~stats()
       output(prefix + "max_msc", ba::max(m_mscs[rt]));
       output(prefix + "mean_mqc", ba::mean(m_mqcs[rt]));
       output(prefix + "max_mqc", ba::max(m_mqcs[rt]));
+
+      // The search time for the classes of searches.
+      output_classes(prefix + "ncu_", m_th[rt].m_ncu);
+      output_classes(prefix + "hops_", m_th[rt].m_hops);
+      output_classes(prefix + "util_", m_th[rt].m_util);
+    }
+
+  // The quality of the approximate searches.
+  for (const auto &[rt, a]: m_approx)
+    {
+      const string prefix = routing::to_string(rt) + "_vs_gd_";
+      output(prefix + "searches", a.m_searches);
+      output(prefix + "misses", a.m_misses);
+      output(prefix + "worse", a.m_worse);
+      output(prefix + "mean_rloss", ba::mean(a.m_rloss));
+      output(prefix + "max_rloss", ba::max(a.m_rloss));
+    }
+
+  // The feasibility pre-pass.
+  if (m_args.prepass)
+    {
+      output("prepass_runs", ba::count(m_prepass_t));
+      output("prepass_blocked", m_prepass_blocked);
+      output("prepass_mean_time", ba::mean(m_prepass_t));
+      output("prepass_max_time", ba::max(m_prepass_t));
+    }
+
+  // The speculative routing.
+  if (m_args.speculate)
+    {
+      output("spec_hits", m_spec_hits);
+      output("spec_conflicts", m_spec_conflicts);
+    }
+
+  // The cache of the generic Dijkstra results.
+  if (m_args.gd_cache)
+    {
+      output("gd_cache_hits", m_cache_hits);
+      output("gd_cache_misses", m_cache_misses);
+    }
+
+  // The learned path pairs.
+  if (m_args.gd_learn)
+    {
+      output("gd_learn_hits", m_learn_hits);
+      output("gd_learn_misses", m_learn_misses);
+      output("gd_learn_checks", m_learn_checks);
+      output("gd_learn_worse", m_learn_worse);
+    }
+
+  // The budget of the generic Dijkstra search.
+  if (m_args.gd_labels || m_args.gd_time > 0)
+    {
+      output("gd_budget_hits", m_budget_hits);
+      output("gd_budget_fallbacks", m_budget_fallbacks);
+      output("gd_budget_mean_gap", ba::mean(m_budget_gap));
+      output("gd_budget_max_gap", ba::max(m_budget_gap));
+      output("gd_budget_mean_rgap", ba::mean(m_budget_rgap));
+      output("gd_budget_max_rgap", ba::max(m_budget_rgap));
     }
 
   // The number of currently active connections.
@@ -87,14 +200,24 @@ stats::get()
 void
 stats::operator()(const double st)
 {
+  // The spectrum occupancy of the network.
+  const occupancy &occ = routing::get_occupancy();
+
   // The current network utilization.
-  m_utilization(calculate_utilization(m_mdl));
+  double utilization = occ.utilization();
+  m_utilization(utilization);
   // The number of connections served.
-  m_conns(m_tra.nr_clients());
+  int conns = m_tra.nr_clients();
+  m_conns(conns);
   // The capacity served.
-  m_capser(m_tra.capacity_served());
+  COST capser = m_tra.capacity_served();
+  m_capser(capser);
   // The number of fragments.
-  m_frags(calculate_frags());
+  double frags = occ.mean_frags();
+  m_frags(frags);
+
+  if (m_stream)
+    stream_row(st, utilization, conns, capser, frags);
 
   schedule(st);
 }
@@ -109,12 +232,15 @@ stats::schedule(const double t)
 
 void
 stats::algo_perf(const routing::rt_t rt, const double dt,
-                 const int &ncu,
-                 const pair<array<unsigned long, 4>,
+                 const demand &d,
+                 const pair<array<unsigned long, 5>,
                             optional<cupp>> &p)
 {
   if (m_args.kickoff <= now())
     {
+      // The number of contiguous units requested.
+      const int &ncu = d.second;
+
       ++m_searches[rt];
 
       bool status = static_cast<bool>(p.second);
@@ -136,26 +262,187 @@ stats::algo_perf(const routing::rt_t rt, const double dt,
 
       m_t[rt](dt);
       m_mmwus[rt](mmwu);
+
+      // The search time in nanoseconds.
+      unsigned long ns = std::lround(dt * 1e9);
+      // The utilization in percent, rounded down to tens.
+      int util = routing::get_occupancy().utilization() * 10;
+      time_hists_t &th = m_th[rt];
+      th.m_all(ns);
+      th.m_ncu[ncu](ns);
+      th.m_hops[m_hops[d.first.first][d.first.second]](ns);
+      th.m_util[10 * util](ns);
+
+      if (m_stream)
+        {
+          interval_t &i = m_int[rt];
+          ++i.m_searches;
+          i.m_blocked += !status;
+          i.m_time += dt;
+          i.m_max_time = std::max(i.m_max_time, dt);
+          i.m_th(ns);
+        }
       m_mpqcs[rt](mpqc);
       m_mscs[rt](msc);
       m_mqcs[rt](mqc);
     }
 }
 
-double
-stats::calculate_frags()
+void
+stats::approx_perf(const routing::rt_t rt, const optional<cupp> &e,
+                   const optional<cupp> &p)
 {
-  dbl_acc frags;
+  if (m_args.kickoff <= now())
+    {
+      approx_t &a = m_approx[rt];
+      ++a.m_searches;
+
+      if (e && !p)
+        ++a.m_misses;
 
-  // Iterate over all edges.
-  graph::edge_iterator ei, ee;
-  for (tie(ei, ee) = boost::edges(m_mdl); ei != ee; ++ei)
+      if (e && p)
+        {
+          COST ec = get_cost(m_mdl, e.value());
+          COST pc = get_cost(m_mdl, p.value());
+          // The approximate result cannot be better than the exact.
+          assert(ec <= pc);
+          a.m_worse += ec < pc;
+          a.m_rloss((pc - ec) / ec);
+        }
+    }
+}
+
+void
+stats::prepass_perf(double dt, bool feasible)
+{
+  if (m_args.kickoff <= now())
     {
-      const edge e = *ei;
-      const SU &su = boost::get(boost::edge_su, m_mdl, e);
-      int f = su.size();
-      frags(f);
+      m_prepass_t(dt);
+      m_prepass_blocked += !feasible;
     }
+}
+
+void
+stats::spec_perf(bool hit)
+{
+  if (m_args.kickoff <= now())
+    {
+      m_spec_hits += hit;
+      m_spec_conflicts += !hit;
+    }
+}
+
+void
+stats::cache_perf(bool hit)
+{
+  if (m_args.kickoff <= now())
+    {
+      m_cache_hits += hit;
+      m_cache_misses += !hit;
+    }
+}
+
+void
+stats::learn_perf(bool hit)
+{
+  if (m_args.kickoff <= now())
+    {
+      m_learn_hits += hit;
+      m_learn_misses += !hit;
+    }
+}
+
+void
+stats::learn_check(const optional<cupp> &e, const optional<cupp> &p)
+{
+  if (m_args.kickoff <= now())
+    {
+      // The exact search finds a result whenever a fit exists.
+      assert(e && p);
+      COST ec = get_cost(m_mdl, e.value());
+      COST pc = get_cost(m_mdl, p.value());
+      // The fit cannot be better than the exact result.
+      assert(ec <= pc);
+      ++m_learn_checks;
+      m_learn_worse += ec < pc;
+    }
+}
+
+void
+stats::budget_hit(const demand &d, COST lb, const optional<cupp> &p,
+                  bool fallback)
+{
+  if (m_args.kickoff <= now())
+    {
+      ++m_budget_hits;
+      m_budget_fallbacks += fallback;
+
+      if (p)
+        {
+          COST gap = get_cost(m_mdl, p.value()) - lb;
+          m_budget_gap(gap);
+          if (lb > 0)
+            m_budget_rgap(gap / lb);
+        }
+    }
+}
+
+void
+stats::stream_header()
+{
+  ostringstream os;
+
+  os << "time,utilization,conns,capser,frags";
+
+  for (const auto &e: m_int)
+    {
+      const string prefix = routing::to_string(e.first) + '_';
+      os << ',' << prefix << "searches"
+         << ',' << prefix << "bp"
+         << ',' << prefix << "mean_time"
+         << ',' << prefix << "max_time"
+         << ',' << prefix << "p50_time"
+         << ',' << prefix << "p90_time"
+         << ',' << prefix << "p99_time"
+         << ',' << prefix << "p999_time";
+    }
+
+  os << '\n';
+
+  m_stream->write(os.str());
+}
+
+void
+stats::stream_row(double t, double utilization, int conns,
+                  COST capser, double frags)
+{
+  ostringstream os;
+
+  os << t << ',' << utilization << ',' << conns << ',' << capser
+     << ',' << frags;
+
+  for (auto &e: m_int)
+    {
+      interval_t &i = e.second;
+
+      os << ',' << i.m_searches;
+
+      if (i.m_searches)
+        os << ',' << static_cast<double>(i.m_blocked) / i.m_searches
+           << ',' << i.m_time / i.m_searches
+           << ',' << i.m_max_time
+           << ',' << seconds(i.m_th.quantile(0.5))
+           << ',' << seconds(i.m_th.quantile(0.9))
+           << ',' << seconds(i.m_th.quantile(0.99))
+           << ',' << seconds(i.m_th.quantile(0.999));
+      else
+        os << ",,,,,,,";
+
+      // Start the next interval.
+      i = interval_t();
+    }
+
+  os << '\n';
 
-  return ba::mean(frags);
+  m_stream->write(os.str());
 }
@@ -5,13 +5,16 @@
 #include "connection.hpp"
 #include "event.hpp"
 #include "graph.hpp"
+#include "histogram.hpp"
 #include "module.hpp"
 #include "routing.hpp"
 #include "sim.hpp"
 #include "traffic.hpp"
+#include "writer.hpp"
 
 #include <chrono>
 #include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -33,9 +36,6 @@ class stats: public module<sim>
   // The arguments of the run.
   const cli_args &m_args;
 
-  // The number of instantaneous measurements of the network state.
-  const int nom = 100;
-
   // The time difference for taking the instantaneous measurements.
   const sim::time_type m_dt;
 
@@ -62,6 +62,25 @@ class stats: public module<sim>
   // The time taken by a search.
   std::map<routing::rt_t, dbl_acc> m_t;
 
+  // The histograms of the time taken by a search, in nanoseconds.
+  struct time_hists_t
+  {
+    // All searches.
+    histogram m_all;
+    // Broken down by the number of contiguous units requested.
+    std::map<int, histogram> m_ncu;
+    // Broken down by the number of hops of the shortest path.
+    std::map<int, histogram> m_hops;
+    // Broken down by the network utilization at the search time, in
+    // percent rounded down to tens.
+    std::map<int, histogram> m_util;
+  };
+
+  std::map<routing::rt_t, time_hists_t> m_th;
+
+  // The number of hops of the shortest paths.
+  std::vector<std::vector<int>> m_hops;
+
   // The number of searches.
   std::map<routing::rt_t, unsigned> m_searches;
   
@@ -71,6 +90,59 @@ class stats: public module<sim>
   std::map<routing::rt_t, dbl_acc> m_mscs;
   std::map<routing::rt_t, dbl_acc> m_mqcs;
 
+  // The number of times the budget of the generic Dijkstra search was
+  // exceeded, and the number of times the edge exclusion search was
+  // run then.
+  unsigned long m_budget_hits = 0;
+  unsigned long m_budget_fallbacks = 0;
+  // The gap between the cost of the path pair found when the budget
+  // was exceeded, and the lower bound on the optimal cost: absolute
+  // and relative to the lower bound.
+  dbl_acc m_budget_gap;
+  dbl_acc m_budget_rgap;
+
+  // The quality of the results of an approximate search compared with
+  // the exact results of the generic Dijkstra search.
+  struct approx_t
+  {
+    // The number of searches compared.
+    unsigned long m_searches = 0;
+    // The number of searches which found no result, while the exact
+    // search did.
+    unsigned long m_misses = 0;
+    // The number of results of a higher cost than the exact result.
+    unsigned long m_worse = 0;
+    // The excess cost relative to the exact cost.
+    dbl_acc m_rloss;
+  };
+
+  std::map<routing::rt_t, approx_t> m_approx;
+
+  // The number of demands blocked by the feasibility pre-pass, and
+  // the time taken by the pre-pass.
+  unsigned long m_prepass_blocked = 0;
+  dbl_acc m_prepass_t;
+
+  // The number of speculative search results used, and the number of
+  // the results discarded, because of the conflicts with the
+  // connections set up or torn down after the speculation.
+  unsigned long m_spec_hits = 0;
+  unsigned long m_spec_conflicts = 0;
+
+  // The number of the cached generic Dijkstra results used, and the
+  // number of the searches run, because no valid result was cached.
+  unsigned long m_cache_hits = 0;
+  unsigned long m_cache_misses = 0;
+
+  // The number of the demands which fit into the learned path pairs,
+  // and of the demands which did not.  Of the fits, the number of the
+  // fits checked against the exact results, and of the fits found of
+  // a higher cost.
+  unsigned long m_learn_hits = 0;
+  unsigned long m_learn_misses = 0;
+  unsigned long m_learn_checks = 0;
+  unsigned long m_learn_worse = 0;
+
   // The number of connections served.
   dbl_acc m_conns;
   // The capacity served.
@@ -78,6 +150,27 @@ class stats: public module<sim>
   // The number of fragments.
   dbl_acc m_frags;
 
+  // The statistics of an algorithm in the interval between two
+  // instantaneous measurements.
+  struct interval_t
+  {
+    // The number of searches.
+    unsigned m_searches = 0;
+    // The number of blocked searches.
+    unsigned m_blocked = 0;
+    // The total and the maximal time taken by a search.
+    double m_time = 0;
+    double m_max_time = 0;
+    // The histogram of the time taken by a search.
+    histogram m_th;
+  };
+
+  // The statistics of the current interval.
+  std::map<routing::rt_t, interval_t> m_int;
+
+  // The stream of the instantaneous measurements, if requested.
+  std::unique_ptr<async_writer> m_stream;
+
 public:
   stats(const cli_args &, const traffic &);
 
@@ -95,14 +188,57 @@ public:
   // Report the algorithm performance.
   void
   algo_perf(const routing::rt_t rt, const double dt,
-            const int &ncu,
-            const std::pair<std::array<unsigned long, 4>,
+            const demand &d,
+            const std::pair<std::array<unsigned long, 5>,
                             std::optional<cupp>> &p);
 
+  // Report the result p of the approximate search rt along with the
+  // exact result e of the generic Dijkstra search.
+  void
+  approx_perf(const routing::rt_t rt, const std::optional<cupp> &e,
+              const std::optional<cupp> &p);
+
+  // Report the time taken by the feasibility pre-pass, and whether
+  // the demand was feasible.
+  void
+  prepass_perf(double dt, bool feasible);
+
+  // Report whether the result of a speculative search was used.
+  void
+  spec_perf(bool hit);
+
+  // Report whether a cached result of the generic Dijkstra search was
+  // used.
+  void
+  cache_perf(bool hit);
+
+  // Report whether the demand fit into the learned path pairs.
+  void
+  learn_perf(bool hit);
+
+  // Report the fit p into the learned path pairs along with the exact
+  // result e of the generic Dijkstra search.
+  void
+  learn_check(const std::optional<cupp> &e, const std::optional<cupp> &p);
+
+  // Report that the budget of the generic Dijkstra search was
+  // exceeded for the demand.  The lower bound on the optimal cost is
+  // lb, and p is the path pair used, found by the edge exclusion
+  // search if fallback is true.
+  void
+  budget_hit(const demand &d, COST lb, const std::optional<cupp> &p,
+             bool fallback);
+
 private:
-  // Calculate the average number of fragments on a link.
-  double
-  calculate_frags();
+  // Write the header of the stream.
+  void
+  stream_header();
+
+  // Write the instantaneous measurements of the network state, and
+  // the statistics of the interval that ended at time t.
+  void
+  stream_row(double t, double utilization, int conns, COST capser,
+             double frags);
 };
 
 #endif
@@ -0,0 +1,176 @@
+#include "sw.hpp"
+
+#include "adaptive_units.hpp"
+#include "ksp.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+// The pair of a window: the total length, and the edge IDs of the
+// paths, shorter first.
+using window_t = pair<COST, pair<vector<eid>, vector<eid>>>;
+
+// The length of the path of the edge IDs, summed in the path order.
+static COST
+length(const graph &g, const vector<edge> &es, const vector<eid> &p)
+{
+  COST l = 0;
+  for (eid i: p)
+    l += boost::get(boost::edge_weight, g, es[i]);
+
+  return l;
+}
+
+// The path of the edge IDs with the CU.
+static cupath
+make_cupath(const vector<edge> &es, const CU &cu, const vector<eid> &p)
+{
+  cupath result(cu, path());
+  for (eid i: p)
+    result.second.push_back(es[i]);
+
+  return result;
+}
+
+// Scan the windows of u units within cu for the demand, and return the
+// first window of the shortest pair, and the pair.  The length of the
+// shortest pair in the whole graph is lb.
+static optional<pair<unsigned, window_t>>
+scan(const graph &g, const occupancy &o, const vector<edge> &es,
+     const demand &d, const CU &cu, unsigned u, COST lb,
+     unsigned threads)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  int ncu = d.second;
+
+  // The bitmaps of the windows of the edges, edge after edge.
+  unsigned nw = o.num_words();
+  vector<uint64_t> bits(es.size() * nw);
+  for (unsigned e = 0; e < es.size(); ++e)
+    o.windows(e, u, &bits[e * nw]);
+
+  auto is_free = [&](unsigned e, unsigned s)
+                 {
+                   return bool(bits[e * nw + s / 64] >> (s % 64) & 1);
+                 };
+
+  // The number of windows, which start at cu.min().
+  unsigned n = cu.max() - u - cu.min() + 1;
+
+  // The pairs of the windows.
+  vector<optional<window_t>> rs(n);
+
+  // The index of the next window to scan.
+  atomic<unsigned> next(0);
+  // The index of the first window of a pair of length lb, n if none.
+  atomic<unsigned> stop(n);
+
+  auto worker = [&]()
+                {
+                  // The edges free in the window.
+                  vector<bool> usable(es.size());
+
+                  for (unsigned i; (i = next++) < stop;)
+                    {
+                      unsigned s = cu.min() + i;
+                      bool same = i;
+                      for (unsigned e = 0; e < es.size(); ++e)
+                        {
+                          usable[e] = is_free(e, s);
+                          same = same && usable[e] == is_free(e, s - 1);
+                        }
+
+                      // The previous window has the same pair, and it
+                      // comes first.
+                      if (same)
+                        continue;
+
+                      auto p = suurballe(g, es, src, dst, &usable);
+                      if (!p)
+                        continue;
+
+                      // Both paths have to be reached with u units.
+                      COST l1 = length(g, es, p->first);
+                      COST l2 = length(g, es, p->second);
+                      if (adaptive_units<COST>::units(ncu, l2) > int(u))
+                        continue;
+                      assert(l1 <= l2);
+
+                      rs[i].emplace(l1 + l2, std::move(p.value()));
+
+                      if (l1 + l2 <= lb)
+                        for (unsigned j = stop;
+                             i < j && !stop.compare_exchange_weak(j, i);)
+                          ;
+                    }
+                };
+
+  // The calling thread is a worker too.
+  vector<thread> ts;
+  for (unsigned i = 1; i < min(max(1u, threads), n); ++i)
+    ts.emplace_back(worker);
+  worker();
+  for (auto &t: ts)
+    t.join();
+
+  // The windows up to the stop window are all scanned, and the ones
+  // after cannot be better, and so the result does not depend on the
+  // threads.
+  optional<pair<unsigned, window_t>> result;
+  for (unsigned i = 0; i < n && i <= stop; ++i)
+    if (rs[i] && (!result || rs[i]->first < result->second.first))
+      result.emplace(cu.min() + i, std::move(rs[i].value()));
+
+  return result;
+}
+
+optional<cupp>
+sw(const graph &g, const occupancy &o, const vector<edge> &es,
+   const demand &d, const CU &cu, unsigned threads)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  // The number of contiguous units at the highest modulation level.
+  unsigned ncu = d.second;
+
+  // The length of the shortest pair in the whole graph, which no
+  // window can beat.
+  COST lb;
+  if (auto sp = suurballe(g, es, src, dst))
+    lb = length(g, es, sp->first) + length(g, es, sp->second);
+  else
+    return {};
+
+  optional<cupp> result;
+  // The cost of the result.
+  COST best = 0;
+
+  // The number of units at the lowest modulation level.
+  unsigned umax = adaptive_units<COST>::m_M * ncu;
+
+  for (unsigned u = ncu; u <= min(umax, cu.count()); ++u)
+    {
+      // No pair of u units can be cheaper.
+      if (result && !(u * lb < best))
+        break;
+
+      if (auto w = scan(g, o, es, d, cu, u, lb, threads))
+        if (COST c = u * w->second.first; !result || c < best)
+          {
+            best = c;
+            CU wcu(w->first, w->first + u);
+            result = cupp(make_cupath(es, wcu, w->second.second.first),
+                          make_cupath(es, wcu, w->second.second.second));
+          }
+    }
+
+  return result;
+}
@@ -0,0 +1,39 @@
+#ifndef SW_HPP
+#define SW_HPP
+
+#include "graph.hpp"
+#include "occupancy.hpp"
+#include "units.hpp"
+
+#include <optional>
+#include <vector>
+
+// The slot window search.  When the modulation is fixed, so that both
+// paths take the same number of units u, and they take the same
+// window of units, the problem decomposes by the window: for every
+// window of u units within cu, the edges where the window is free make
+// up a subgraph, in which the Suurballe algorithm finds the shortest
+// pair of edge-disjoint paths.  The cheapest pair of all windows,
+// first window first, is optimal for u.
+//
+// The modulation levels are tried from the fewest units up, and a
+// path can use a level of more units than its length requires.  A
+// window is skipped if its shortest pair has a path too long for the
+// level, even though a longer pair of shorter paths could fit, and so
+// the search is exact for the demands which the level of the result
+// reaches.  The generic Dijkstra search also lets the paths take
+// different windows, and adapts the modulation of every path, and so
+// its result cannot be more expensive, which makes this search an
+// independent check of it.
+//
+// The windows of a level are scanned by the given number of threads.
+// A window free on the same edges as the previous window is skipped,
+// and the scan stops once a pair of the length of the shortest pair
+// in the whole graph is found, because no later window can do better.
+// The levels stop when their lower bound reaches the cost found.  The
+// edge descriptors es are indexed with the edge ID.
+std::optional<cupp>
+sw(const graph &g, const occupancy &o, const std::vector<edge> &es,
+   const demand &d, const CU &cu, unsigned threads);
+
+#endif // SW_HPP
@@ -0,0 +1,71 @@
+#define BOOST_TEST_MODULE calendar_queue
+
+#include "calendar_queue.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(calendar_queue_fifo)
+{
+  calendar_queue<double, int> q;
+  BOOST_CHECK(q.empty());
+
+  // The entries of the same time are dequeued in the push order.
+  for (int i = 0; i < 10; ++i)
+    q.push(i % 2, i);
+
+  BOOST_CHECK(q.size() == 10);
+
+  vector<int> vs;
+  for (; !q.empty(); q.pop())
+    vs.push_back(q.top_value());
+
+  BOOST_CHECK(vs == vector<int>({0, 2, 4, 6, 8, 1, 3, 5, 7, 9}));
+}
+
+// Compare with the priority queue for random pushes and pops, with
+// the times not earlier than the time of the last pop, as in a
+// simulation.
+BOOST_AUTO_TEST_CASE(calendar_queue_random)
+{
+  calendar_queue<double, int> q;
+  // The time, the sequence number, and the value.
+  typedef tuple<double, int, int> entry;
+  priority_queue<entry, vector<entry>, greater<entry>> r;
+
+  minstd_rand eng;
+  exponential_distribution<> ed(1);
+  uniform_int_distribution<> ud(0, 2);
+
+  double now = 0;
+  int seq = 0;
+
+  for (int i = 0; i < 100000; ++i)
+    if (ud(eng) || r.empty())
+      {
+        // Sometimes the time is the same as now.
+        double t = now + (i % 7 ? ed(eng) * (1 + i % 1000) : 0);
+        q.push(t, i);
+        r.push({t, seq++, i});
+      }
+    else
+      {
+        BOOST_REQUIRE(q.size() == r.size());
+        BOOST_REQUIRE(q.top_time() == get<0>(r.top()));
+        BOOST_REQUIRE(q.top_value() == get<2>(r.top()));
+        now = q.top_time();
+        q.pop();
+        r.pop();
+      }
+
+  for (; !r.empty(); r.pop(), q.pop())
+    BOOST_REQUIRE(q.top_value() == get<2>(r.top()));
+
+  BOOST_CHECK(q.empty());
+}
@@ -10,8 +10,11 @@
 
 #include <optional>
 #include <queue>
+#include <random>
+#include <set>
 #include <utility>
 #include <tuple>
+#include <vector>
 
 using namespace std;
 
@@ -53,6 +56,8 @@ BOOST_AUTO_TEST_CASE(ideas_1)
   assert(p3.second);
   assert(p4.second);
 
+  set_edge_index(g);
+
   const edge &e1 = p1.first;
   const edge &e2 = p2.first;
   const edge &e3 = p3.first;
@@ -71,7 +76,7 @@ BOOST_AUTO_TEST_CASE(ideas_1)
 
   // Search for edge-disjoint paths of minimal weight.
   demand d(npair(0, 2), 1);
-  auto opaths = get<4>(gd(g, d, CU{0, 4}));
+  auto opaths = gd(g, get_edges(g), d, CU{0, 4}).second;
   assert(opaths);
   auto paths = opaths.value();
 
@@ -148,6 +153,8 @@ BOOST_AUTO_TEST_CASE(ideas_1a)
   assert(p3.second);
   assert(p4.second);
 
+  set_edge_index(g);
+
   const edge &e1 = p1.first;
   const edge &e2 = p2.first;
   const edge &e3 = p3.first;
@@ -166,7 +173,7 @@ BOOST_AUTO_TEST_CASE(ideas_1a)
 
   // Search for edge-disjoint paths of minimal weight.
   demand d(npair(0, 2), 1);
-  auto opaths = get<4>(gd(g, d, CU{0, 4}));
+  auto opaths = gd(g, get_edges(g), d, CU{0, 4}).second;
   assert(opaths);
   auto paths = opaths.value();
 
@@ -247,6 +254,8 @@ BOOST_AUTO_TEST_CASE(ideas_2)
   assert(p4.second);
   assert(p5.second);
 
+  set_edge_index(g);
+
   const edge &e1 = p1.first;
   const edge &e2 = p2.first;
   const edge &e3 = p3.first;
@@ -269,7 +278,7 @@ BOOST_AUTO_TEST_CASE(ideas_2)
 
   // Search for edge-disjoint paths of minimal weight.
   demand d(npair(0, 3), 1);
-  auto opaths = get<4>(gd(g, d, CU{0, 4}));
+  auto opaths = gd(g, get_edges(g), d, CU{0, 4}).second;
   assert(opaths);
   auto paths = opaths.value();
 
@@ -358,6 +367,8 @@ BOOST_AUTO_TEST_CASE(ideas_3)
   assert(p4.second);
   assert(p5.second);
 
+  set_edge_index(g);
+
   const edge &e1 = p1.first;
   const edge &e1a = p1a.first;
   const edge &e2 = p2.first;
@@ -386,7 +397,7 @@ BOOST_AUTO_TEST_CASE(ideas_3)
 
   // Search for edge-disjoint paths of minimal weight.
   demand d(npair(0, 3), 1);
-  auto opaths = get<4>(gd(g, d, CU{0, 4}));
+  auto opaths = gd(g, get_edges(g), d, CU{0, 4}).second;
   assert(opaths);
   auto paths = opaths.value();
 
@@ -426,3 +437,155 @@ BOOST_AUTO_TEST_CASE(ideas_3)
     BOOST_CHECK(i == paths.second.second.end());
   }
 }
+
+// -------------------------------------------------------------------
+//
+// A random graph of n vertexes for the equivalence tests: a ring with
+// m chords, possibly parallel.  The weights are the same, so that
+// many labels are of the same cost, and the buckets of the parallel
+// search are large.  The SUs are random CUs of 64 units.
+static graph
+random_graph(unsigned n, unsigned m, unsigned seed)
+{
+  std::minstd_rand rne(seed);
+  std::uniform_int_distribution<unsigned> vd(0, n - 1);
+  std::uniform_int_distribution<int> ud(0, 63);
+
+  graph g(n);
+  for (unsigned i = 0; i < n + m; ++i)
+    {
+      unsigned a = i < n ? i : vd(rne);
+      unsigned b = i < n ? (i + 1) % n : vd(rne);
+      if (a == b)
+        b = (a + 1) % n;
+
+      edge e = boost::add_edge(a, b, g).first;
+      boost::get(boost::edge_weight, g, e) = 10;
+      boost::get(boost::edge_nou, g, e) = 64;
+
+      // Two random CUs, possibly overlapping.
+      SU su;
+      for (int j = 0; j < 2; ++j)
+        {
+          int x = ud(rne), y = ud(rne);
+          CU cu(std::min(x, y), std::max(x, y) + 1);
+          if (std::none_of(su.begin(), su.end(), [&](const CU &c)
+                           {return c.max() >= cu.min() &&
+                              cu.max() >= c.min();}))
+            su.insert(cu);
+        }
+      boost::get(boost::edge_su, g, e) = su;
+    }
+
+  set_edge_index(g);
+
+  return g;
+}
+
+// Take the first unit available on edge e.
+static void
+take_unit(graph &g, const edge &e)
+{
+  SU &su = boost::get(boost::edge_su, g, e);
+  if (!su.empty())
+    su.remove(CU(su.front().min(), su.front().min() + 1));
+}
+
+// The search with more threads returns the same as with one.
+BOOST_AUTO_TEST_CASE(gd_threads)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g = random_graph(24, 24, 1);
+  auto es = get_edges(g);
+
+  // The labels made permanent, to make sure the buckets were large.
+  unsigned long labels = 0;
+
+  for (unsigned dst = 1; dst < num_vertices(g); ++dst)
+    {
+      demand d(npair(0, dst), 1);
+
+      gd_budget b1;
+      b1.m_threads = 1;
+      auto p1 = gd(g, es, d, CU(0, 64), &b1);
+
+      gd_budget b4;
+      b4.m_threads = 4;
+      auto p4 = gd(g, es, d, CU(0, 64), &b4);
+
+      BOOST_CHECK(p1.first == p4.first);
+      BOOST_CHECK(p1.second == p4.second);
+      labels += p1.first[4];
+    }
+
+  BOOST_CHECK(labels > 10000);
+}
+
+// The search that resumes the state returns the same as the search
+// anew, when the SUs read by the search change.
+BOOST_AUTO_TEST_CASE(gd_incremental)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g = random_graph(16, 16, 2);
+  auto es = get_edges(g);
+  std::minstd_rand rne(2);
+  std::uniform_int_distribution<unsigned> ed(0, num_edges(g) - 1);
+
+  gd_state s;
+  // The number of the steps kept by the state.
+  std::size_t kept = 0;
+
+  for (int i = 0; i < 20; ++i)
+    {
+      // The demands alternate every five searches.
+      demand d(npair(0, i % 10 < 5 ? 9 : 13), 1);
+
+      auto ps = gd(g, es, d, CU(0, 64), nullptr, nullptr, nullptr, &s);
+      auto pn = gd(g, es, d, CU(0, 64));
+
+      BOOST_CHECK(ps.first == pn.first);
+      BOOST_CHECK(ps.second == pn.second);
+
+      // Change the SUs of two random edges.
+      std::set<eid> changed = {ed(rne), ed(rne)};
+      for (eid e: changed)
+        take_unit(g, es[e]);
+
+      s.invalidate([&](eid e){return changed.count(e);});
+      kept += s.m_keep;
+    }
+
+  // Some steps must have been kept, or the rewind was not tested.
+  BOOST_CHECK(kept > 0);
+}
+
+// The search returns the same result, as long as the SUs of the edges
+// it read have not changed, which makes the cached result valid.
+BOOST_AUTO_TEST_CASE(gd_cache)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g = random_graph(16, 16, 3);
+  auto es = get_edges(g);
+
+  for (unsigned dst = 1; dst < num_vertices(g); ++dst)
+    {
+      demand d(npair(0, dst), 1);
+
+      std::vector<eid> reads;
+      auto pc = gd(g, es, d, CU(0, 64), nullptr, nullptr, &reads);
+
+      // Change the SUs of the edges not read.
+      std::set<eid> read(reads.begin(), reads.end());
+      for (eid e = 0; e < es.size(); ++e)
+        if (!read.count(e))
+          take_unit(g, es[e]);
+
+      auto pn = gd(g, es, d, CU(0, 64));
+
+      BOOST_CHECK(pc.first == pn.first);
+      BOOST_CHECK(pc.second == pn.second);
+    }
+}
@@ -0,0 +1,50 @@
+#define BOOST_TEST_MODULE histogram
+
+#include "histogram.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(histogram_empty)
+{
+  histogram h;
+  BOOST_CHECK(h.count() == 0);
+  BOOST_CHECK(h.quantile(0.5) == 0);
+}
+
+// The small values have their own buckets, so the quantiles are
+// exact.
+BOOST_AUTO_TEST_CASE(histogram_exact)
+{
+  histogram h;
+
+  for (unsigned long v = 1; v <= 50; ++v)
+    h(v);
+
+  BOOST_CHECK(h.count() == 50);
+  BOOST_CHECK(h.max() == 50);
+  BOOST_CHECK(h.quantile(0) == 1);
+  BOOST_CHECK(h.quantile(0.5) == 25);
+  BOOST_CHECK(h.quantile(0.9) == 45);
+  BOOST_CHECK(h.quantile(1) == 50);
+}
+
+// The large values are reported with a bounded relative error.
+BOOST_AUTO_TEST_CASE(histogram_log)
+{
+  histogram h;
+
+  for (unsigned long v = 1; v <= 1000000; ++v)
+    h(v * 1000);
+
+  for (double q: {0.1, 0.5, 0.9, 0.99, 0.999})
+    {
+      double expected = q * 1000000 * 1000;
+      double reported = h.quantile(q);
+      BOOST_CHECK(expected <= reported);
+      BOOST_CHECK(reported <= expected * (1 + 1.0 / 32));
+    }
+
+  BOOST_CHECK(h.quantile(1) == 1000000000);
+}
@@ -0,0 +1,75 @@
+#define BOOST_TEST_MODULE ksp
+
+#include "adaptive_units.hpp"
+#include "graph.hpp"
+#include "ksp.hpp"
+#include "units.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// -------------------------------------------------------------------
+//
+// The trap topology: removing the shortest path (0) - (1) - (2) - (3)
+// leaves no path from (0) to (3), but there are two edge-disjoint
+// paths through edges e3 and e4.  The weights of e3 and e4 are 3 and
+// 4, and of the other edges 1.
+//
+//     e0      e1      e2
+// (0) --- (1) --- (2) --- (3)
+//   \       \_e4_________/
+//    \_e3_________/
+//
+BOOST_AUTO_TEST_CASE(ksp_trap)
+{
+  graph g(4);
+  vector<edge> es;
+  for (auto [a, b, w]: {tuple(0, 1, 1), tuple(1, 2, 1), tuple(2, 3, 1),
+                        tuple(0, 2, 3), tuple(1, 3, 4)})
+    {
+      auto [e, ok] = boost::add_edge(a, b, g);
+      boost::get(boost::edge_weight, g)[e] = w;
+      es.push_back(e);
+    }
+  set_units(g, 4);
+  set_edge_index(g);
+  adaptive_units<COST>::set_reach_1(160);
+
+  auto sp = suurballe(g, es, 0, 3);
+  BOOST_REQUIRE(sp);
+  BOOST_CHECK(sp->first == vector<eid>({3, 2}));
+  BOOST_CHECK(sp->second == vector<eid>({0, 4}));
+
+  auto ps = yen(g, es, 0, 3, 4);
+  BOOST_REQUIRE(ps.size() == 4);
+  BOOST_CHECK(ps[0] == vector<eid>({0, 1, 2}));
+  BOOST_CHECK(ps[1] == vector<eid>({3, 2}));
+  BOOST_CHECK(ps[2] == vector<eid>({0, 4}));
+  BOOST_CHECK(ps[3] == vector<eid>({3, 1, 4}));
+
+  // The Suurballe pair is the only disjoint pair of the Yen paths.
+  ksp_table t;
+  t.build(g, 2, 2);
+  auto [first, last] = t.candidates(3, 0);
+  BOOST_REQUIRE(last - first == 1);
+  BOOST_CHECK(first->m_n1 == 2 && first->m_n2 == 2);
+
+  // The shorter path does not fit first in the units taken on e3.
+  // The paths are reversed for the demand from (3).
+  boost::get(boost::edge_su, g)[es[3]].remove(CU(0, 2));
+  auto p = ksp(g, t, demand(npair(3, 0), 2), CU(0, 4));
+  BOOST_REQUIRE(p);
+  BOOST_CHECK(p->first.first == CU(2, 4));
+  BOOST_CHECK(p->first.second == path({es[2], es[3]}));
+  BOOST_CHECK(p->second.first == CU(0, 2));
+  BOOST_CHECK(p->second.second == path({es[4], es[0]}));
+
+  // Nothing fits with a single unit left on e4.
+  boost::get(boost::edge_su, g)[es[4]].remove(CU(0, 3));
+  BOOST_CHECK(!ksp(g, t, demand(npair(3, 0), 2), CU(0, 4)));
+}
@@ -0,0 +1,146 @@
+#define BOOST_TEST_MODULE occupancy
+
+#include "graph.hpp"
+#include "occupancy.hpp"
+#include "units.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Make sure the counts of the occupancy agree with the SUs of the
+// edges.
+void
+check(const graph &g, const occupancy &o)
+{
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    {
+      unsigned i = boost::get(boost::edge_index, g, e);
+      const SU &su = boost::get(boost::edge_su, g, e);
+      BOOST_CHECK(o.free_units(i) == su.count());
+      BOOST_CHECK(o.frags(i) == su.size());
+
+      for (unsigned u = 0; u < o.num_units(); ++u)
+        BOOST_CHECK(o.is_free(i, u) == su.includes(CU(u, u + 1)));
+    }
+}
+
+// -------------------------------------------------------------------
+//
+//     e0      e1
+// (0) --- (1) --- (2)
+//
+BOOST_AUTO_TEST_CASE(occupancy_1)
+{
+  graph g(3);
+  auto [e0, b0] = boost::add_edge(0, 1, g);
+  auto [e1, b1] = boost::add_edge(1, 2, g);
+  set_units(g, 100);
+  set_edge_index(g);
+
+  occupancy o;
+  o.reset(g);
+  BOOST_CHECK(o.num_edges() == 2);
+  BOOST_CHECK(o.num_units() == 100);
+  BOOST_CHECK(o.utilization() == 0);
+  BOOST_CHECK(o.mean_frags() == 1);
+  check(g, o);
+
+  auto take = [&g, &o](const edge &e, const CU &cu)
+              {
+                boost::get(boost::edge_su, g)[e].remove(cu);
+                o.take(boost::get(boost::edge_index, g, e), cu);
+                check(g, o);
+              };
+
+  auto give = [&g, &o](const edge &e, const CU &cu)
+              {
+                boost::get(boost::edge_su, g)[e].insert(cu);
+                o.give(boost::get(boost::edge_index, g, e), cu);
+                check(g, o);
+              };
+
+  // Split the only fragment into two, across the word boundary.
+  take(e0, CU(60, 70));
+  BOOST_CHECK(o.frags(0) == 2);
+  BOOST_CHECK(o.mean_frags() == 1.5);
+  BOOST_CHECK(o.utilization() == 0.05);
+
+  // Take from the left end, and from the right end.
+  take(e0, CU(0, 10));
+  take(e0, CU(90, 100));
+  BOOST_CHECK(o.frags(0) == 2);
+
+  // Remove a fragment entirely.
+  take(e0, CU(70, 90));
+  BOOST_CHECK(o.frags(0) == 1);
+
+  // Give back and merge on both sides.
+  give(e0, CU(70, 90));
+  give(e0, CU(60, 70));
+  BOOST_CHECK(o.frags(0) == 1);
+  give(e0, CU(0, 10));
+  give(e0, CU(90, 100));
+  BOOST_CHECK(o.utilization() == 0);
+
+  // The whole edge.
+  take(e1, CU(0, 100));
+  BOOST_CHECK(o.frags(1) == 0);
+  BOOST_CHECK(o.mean_frags() == 0.5);
+  BOOST_CHECK(o.utilization() == 0.5);
+  give(e1, CU(0, 100));
+}
+
+// The occupancy is built from the SUs that are already partially
+// taken.
+BOOST_AUTO_TEST_CASE(occupancy_2)
+{
+  graph g(2);
+  boost::add_edge(0, 1, g);
+  boost::add_edge(0, 1, g);
+  set_units(g, 130);
+  set_edge_index(g);
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    boost::get(boost::edge_su, g)[e] = SU{{1, 3}, {63, 65}, {128, 130}};
+
+  occupancy o;
+  o.reset(g);
+  check(g, o);
+  BOOST_CHECK(o.mean_frags() == 3);
+}
+
+// The windows of free units, across the word boundaries, compared
+// with the units free one by one.
+BOOST_AUTO_TEST_CASE(occupancy_windows)
+{
+  graph g(2);
+  boost::add_edge(0, 1, g);
+  set_units(g, 200);
+  set_edge_index(g);
+
+  boost::get(boost::edge_su, g)[*edges(g).first] =
+    SU{{1, 3}, {60, 130}, {140, 200}};
+
+  occupancy o;
+  o.reset(g);
+  vector<uint64_t> bits(o.num_words());
+
+  for (unsigned n: {1, 2, 3, 5, 64, 65, 70, 71, 128})
+    {
+      o.windows(0, n, bits.data());
+
+      for (unsigned s = 0; s < bits.size() * 64; ++s)
+        {
+          bool free = s + n <= o.num_units();
+          for (unsigned u = s; free && u < s + n; ++u)
+            free = o.is_free(0, u);
+
+          BOOST_CHECK((bits[s / 64] >> (s % 64) & 1) == free);
+        }
+    }
+}
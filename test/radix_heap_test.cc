@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE radix_heap
+
+#include "radix_heap.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(radix_heap_keys)
+{
+  // The keys keep the order of the non-negative doubles.
+  vector<double> cs = {0, 1e-300, 0.5, 1, 1.5, 2, 3, 1e10, 1e300};
+  for (size_t i = 1; i < cs.size(); ++i)
+    BOOST_CHECK(to_radix_key(cs[i - 1]) < to_radix_key(cs[i]));
+
+  for (double c: cs)
+    BOOST_CHECK(from_radix_key(to_radix_key(c)) == c);
+
+  BOOST_CHECK(to_radix_key(-0.0) == to_radix_key(0.0));
+}
+
+// The entries of the same key are popped in the decreasing order of
+// values, regardless of the order of pushing.
+BOOST_AUTO_TEST_CASE(radix_heap_ties)
+{
+  radix_heap<int> q;
+
+  for (int v: {3, 7, 1})
+    q.push(to_radix_key(2), v);
+  for (int v: {5, 0})
+    q.push(to_radix_key(1), v);
+
+  BOOST_CHECK(q.top_value() == 5);
+  q.pop();
+  // Pushed to the bucket of the key popped last.
+  q.push(to_radix_key(1), 2);
+  q.push(to_radix_key(2), 4);
+
+  for (int v: {2, 0, 7, 4, 3, 1})
+    {
+      BOOST_REQUIRE(q.top_value() == v);
+      q.pop();
+    }
+
+  BOOST_CHECK(q.empty());
+}
+
+// Compare with the priority queue for random pushes and pops, with
+// the keys not smaller than the key of the last pop, as in a
+// label-setting search.
+BOOST_AUTO_TEST_CASE(radix_heap_random)
+{
+  radix_heap<int> q;
+  BOOST_CHECK(q.empty());
+
+  priority_queue<double, vector<double>, greater<double>> r;
+
+  minstd_rand eng;
+  exponential_distribution<> ed(1);
+  uniform_int_distribution<> ud(0, 2);
+
+  double last = 0;
+
+  for (int i = 0; i < 100000; ++i)
+    if (ud(eng) || r.empty())
+      {
+        // Sometimes the key is the same as the last one.
+        double c = last + (i % 7 ? ed(eng) * (1 + i % 1000) : 0);
+        q.push(to_radix_key(c), i);
+        r.push(c);
+      }
+    else
+      {
+        BOOST_REQUIRE(q.size() == r.size());
+        BOOST_REQUIRE(from_radix_key(q.peek_key()) == r.top());
+        BOOST_REQUIRE(from_radix_key(q.top_key()) == r.top());
+        last = r.top();
+        q.pop();
+        r.pop();
+      }
+
+  for (; !r.empty(); r.pop(), q.pop())
+    BOOST_REQUIRE(from_radix_key(q.top_key()) == r.top());
+
+  BOOST_CHECK(q.empty());
+}
@@ -1,19 +1,44 @@
 #include "traffic.hpp"
 
-#include <list>
+#include "routing.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
 
 using namespace std;
 
-traffic::traffic(double mcat, double mht, double mnu):
-  m_catd(1 / mcat), m_mht(mht), m_mnu(mnu), idc()
+traffic::traffic(double mcat, double mht, double mnu,
+                 const string &record, const string &replay,
+                 unsigned speculate):
+  idc(), m_catd(1 / mcat), m_htd(1 / mht), m_nud(mnu - 1),
+  m_speculate(speculate)
 {
-  schedule(0);
+  assert(record.empty() || replay.empty());
+
+  if (!record.empty())
+    m_recorder = make_unique<workload_writer>(record);
+
+  if (!replay.empty())
+    {
+      m_replay = make_unique<workload_reader>(replay);
+      read_ahead();
+
+      if (!m_ahead.empty())
+        schedule(m_ahead.front().m_t);
+    }
+  else
+    schedule(0);
 }
 
 traffic::~traffic()
 {
-  for(auto c: cs)
-    delete c;
+  while(m_head)
+    {
+      client *c = m_head;
+      erase(c);
+      m_pool.destroy(c);
+    }
 
   delete_clients();
 }
@@ -21,7 +46,7 @@ traffic::~traffic()
 int
 traffic::nr_clients() const
 {
-  return cs.size();
+  return m_nc;
 }
 
 void
@@ -30,12 +55,76 @@ traffic::operator()(double t)
   // Before we create new clients, we delete those clients that
   // requested deletion.
   delete_clients();
-  
+
   // We are creating a client, but we ain't doing anything with the
   // pointer we get!  It's so, because it's up to the client to
   // register itself with the traffic.
-  new client(m_mht, m_mnu, *this);
-  schedule_next(t);
+  if (m_replay)
+    {
+      assert(!m_ahead.empty());
+      arrival a = m_ahead.front();
+      m_ahead.pop_front();
+      read_ahead();
+
+      // Search for this and the next arrivals at once, when the
+      // previous speculative results are used up.  The arrival read
+      // ahead for scheduling is not searched for, unless speculated.
+      if (m_speculate && !routing::has_speculations())
+        {
+          vector<demand> ds(1, a.m_d);
+          for (const auto &n: m_ahead)
+            if (ds.size() < m_speculate)
+              ds.push_back(n.m_d);
+          routing::speculate(m_mdl, ds);
+        }
+
+      m_pool.create(a.m_d, a.m_ht, *this);
+
+      if (!m_ahead.empty())
+        {
+          assert(t <= m_ahead.front().m_t);
+          schedule(m_ahead.front().m_t);
+        }
+    }
+  else
+    {
+      demand d = draw_demand();
+      optional<double> ht;
+
+      // When recording, we draw the holding time for every arrival,
+      // even if the connection is not established, so that the
+      // workload recorded doesn't depend on the routing.
+      if (m_recorder)
+        {
+          ht = draw_holding_time();
+          m_recorder->write({t, d, ht.value()});
+        }
+
+      m_pool.create(d, ht, *this);
+      schedule_next(t);
+    }
+}
+
+demand
+traffic::draw_demand()
+{
+  // The new demand.
+  demand d;
+  // The demand end nodes.
+  d.first = random_node_pair(m_mdl, m_rne);
+  // The number of units the signal requires.  It's Poisson + 1.  We
+  // reset the distribution to draw the number as a newly-constructed
+  // distribution would.
+  m_nud.reset();
+  d.second = m_nud(m_rne) + 1;
+
+  return d;
+}
+
+double
+traffic::draw_holding_time()
+{
+  return m_htd(m_rne);
 }
 
 void
@@ -45,45 +134,68 @@ traffic::schedule_next(double t)
   schedule(t + dt);
 }
 
+void
+traffic::read_ahead()
+{
+  // The arrival being processed and the ones read ahead make up the
+  // arrivals searched for speculatively.  At least the next arrival
+  // is read, to schedule it.
+  size_t n = max(m_speculate, 2u) - 1;
+  arrival a;
+
+  while (m_ahead.size() < n && m_replay->read(a))
+    m_ahead.push_back(a);
+}
+
 void
 traffic::insert(client *c)
 {
-  cs.insert(c);
+  assert(!c->m_prev && !c->m_next && c != m_head);
+
+  c->m_next = m_head;
+  if (m_head)
+    m_head->m_prev = c;
+  m_head = c;
+  ++m_nc;
+  m_capser += c->get_connection().get_cost();
 }
 
 void
 traffic::erase(client *c)
 {
-  cs.erase(c);
+  if (c->m_prev)
+    c->m_prev->m_next = c->m_next;
+  else
+    {
+      assert(m_head == c);
+      m_head = c->m_next;
+    }
+
+  if (c->m_next)
+    c->m_next->m_prev = c->m_prev;
+
+  c->m_prev = c->m_next = nullptr;
+  --m_nc;
+  m_capser -= c->get_connection().get_cost();
 }
 
 void
 traffic::delete_me_later(client *c)
 {
-  dl.push(c);
+  dl.push_back(c);
 }
 
 COST
 traffic::capacity_served() const
 {
-  COST capacity = 0;
-
-  // Iterate over all clients.
-  for(const client *cli: cs)
-    {
-      const connection &c = cli->get_connection();
-      capacity += c.get_cost();
-    }
-
-  return capacity;
+  return m_capser;
 }
 
 void
 traffic::delete_clients()
 {
-  while(!dl.empty())
-    {
-      delete dl.front();
-      dl.pop();
-    }
+  for(client *c: dl)
+    m_pool.destroy(c);
+
+  dl.clear();
 }
@@ -4,19 +4,33 @@
 #include "client.hpp"
 #include "graph.hpp"
 #include "module.hpp"
+#include "pool.hpp"
 #include "sim.hpp"
+#include "workload.hpp"
 
-#include <queue>
+#include <deque>
+#include <memory>
 #include <random>
-#include <set>
+#include <string>
+#include <vector>
 
 class traffic: public module<sim>
 {
-  // The set of active clients.
-  std::set<client *> cs;
+  // The pool of clients.
+  pool<client> m_pool;
 
-  // The queue of clients to delete later.
-  std::queue<client *> dl;
+  // The intrusive list of active clients.
+  client *m_head = nullptr;
+
+  // The number of active clients.
+  int m_nc = 0;
+
+  // The capacity served by the active clients.
+  COST m_capser = 0;
+
+  // The clients to delete later.  The vector keeps its capacity, so
+  // that in the steady state it doesn't allocate memory.
+  std::vector<client *> dl;
 
   // The ID counter.
   int idc;
@@ -24,17 +38,39 @@ class traffic: public module<sim>
   // The client arrival time distribution.
   std::exponential_distribution<> m_catd;
 
-  // The mean holding time.
-  double m_mht;
+  // The holding time distribution.
+  std::exponential_distribution<> m_htd;
 
-  // The mean number of units.
-  double m_mnu;
+  // The number of units distribution.
+  std::poisson_distribution<> m_nud;
 
   // Shortest distances.
   mutable std::map<npair, int> sd;
 
+  // The recorder of the arrivals, if requested.
+  std::unique_ptr<workload_writer> m_recorder;
+
+  // The source of the arrivals in the replay mode.
+  std::unique_ptr<workload_reader> m_replay;
+
+  // The next arrivals in the replay mode, read ahead for the
+  // speculative searches.  The first is the next arrival.
+  std::deque<arrival> m_ahead;
+
+  // The number of the arrivals searched for speculatively.
+  unsigned m_speculate;
+
 public:
-  traffic(double mcat, double mht, double mnu);
+  // The traffic with the given mean client arrival time, mean holding
+  // time and mean number of units.  If the record file name is not
+  // empty, every arrival is written to the file.  If the replay file
+  // name is not empty, the arrivals are read from the file, and not
+  // drawn.  In the replay mode, the searches for the given number of
+  // the next arrivals can be run in parallel ahead of time.
+  traffic(double mcat, double mht, double mnu,
+          const std::string &record = {},
+          const std::string &replay = {},
+          unsigned speculate = 0);
 
   ~traffic();
 
@@ -53,13 +89,32 @@ public:
   // Delete this client later.
   void delete_me_later(client *);
 
-  // Calculate the capacity currently served, i.e., the sum of the
-  // products of the number of units used and the weight of an edge.
+  // The capacity currently served, i.e., the sum of the products of
+  // the number of units used and the weight of an edge.  It's kept
+  // up to date as the clients are inserted and erased.
   COST
   capacity_served() const;
 
+  // Call f for every active client.
+  template <typename F>
+  void
+  for_each_client(F f) const
+  {
+    for(const client *c = m_head; c; c = c->m_next)
+      f(*c);
+  }
+
+  // Draw the holding time of a connection.
+  double
+  draw_holding_time();
+
 private:
+  // Draw a demand.
+  demand
+  draw_demand();
+
   void schedule_next(double);
+  void read_ahead();
   void delete_clients();
 };
 
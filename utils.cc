@@ -67,6 +67,37 @@ calc_sp_stats(const graph &g, dbl_acc &hop_acc, dbl_acc &len_acc)
     }
 }
 
+vector<vector<int>>
+calc_sp_hops(const graph &g)
+{
+  vector<vector<int>> result(num_vertices(g),
+                             vector<int>(num_vertices(g)));
+
+  for (vertex src: boost::make_iterator_range(boost::vertices(g)))
+    {
+      vector<int> dist(num_vertices(g));
+      vector<vertex> pred(num_vertices(g));
+
+      boost::dijkstra_shortest_paths
+        (g, src,
+         boost::predecessor_map(&pred[0]).distance_map(&dist[0]));
+
+      for (vertex dst: boost::make_iterator_range(boost::vertices(g)))
+        {
+          int hops = 0;
+          for (vertex c = dst; c != src; c = pred[c])
+            {
+              // Make sure the path was found.
+              assert(pred[c] != c);
+              ++hops;
+            }
+          result[src][dst] = hops;
+        }
+    }
+
+  return result;
+}
+
 double
 calc_mcat(const graph &g, double mnh, double mht, double mnu, double ol)
 {
@@ -101,5 +132,7 @@ load_graphviz(const string &file_name, graph &g)
 
   is.close();
 
+  set_edge_index(g);
+
   return result;
 }
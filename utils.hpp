@@ -301,11 +301,50 @@ set_units(G &g, unsigned units)
     }
 }
 
+/**
+ * Sets the edge_index property on edges.  The edges are numbered
+ * from 0 in the order of the edge iterator.
+ */
+template<typename G>
+void
+set_edge_index(G &g)
+{
+  typename boost::property_map<G, boost::edge_index_t>::type
+    ipm = get(boost::edge_index_t(), g);
+
+  unsigned index = 0;
+  typename G::edge_iterator ei, ee;
+  for (tie(ei, ee) = edges(g); ei != ee; ++ei)
+    ipm[*ei] = index++;
+}
+
+/**
+ * Returns the edge descriptors indexed with the edge_index property.
+ */
+template<typename G>
+std::vector<typename G::edge_descriptor>
+get_edges(const G &g)
+{
+  std::vector<typename G::edge_descriptor> es(num_edges(g));
+
+  typename G::edge_iterator ei, ee;
+  for (tie(ei, ee) = edges(g); ei != ee; ++ei)
+    es[get(boost::edge_index, g, *ei)] = *ei;
+
+  return es;
+}
+
 // For the shortest paths between all node pairs, calculate the
 // statistics for hops and lengths.
 void
 calc_sp_stats(const graph &g, dbl_acc &hop_acc, dbl_acc &len_acc);
 
+// For the shortest paths between all node pairs, calculate the
+// number of hops.  The result is indexed with the source and the
+// target vertexes.
+std::vector<std::vector<int>>
+calc_sp_hops(const graph &g);
+
 // Calculate the mean connection arrival time for the given mean
 // number of hops of a shortest path (mnh), the mean holding time
 // (mht) of a connection, the mean number of units of a connection,
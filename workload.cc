@@ -0,0 +1,79 @@
+#include "workload.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// The magic string at the start of a workload file.
+static const char magic[] = "DDPPWL1\n";
+
+// The size of the magic string without the terminating null.
+static constexpr size_t magic_size = sizeof(magic) - 1;
+
+template <typename T>
+static void
+put(ostream &os, const T &v)
+{
+  os.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+template <typename T>
+static bool
+get(istream &is, T &v)
+{
+  return static_cast<bool>(is.read(reinterpret_cast<char *>(&v),
+                                   sizeof(T)));
+}
+
+workload_writer::workload_writer(const string &file_name):
+  m_os(file_name, ios::binary)
+{
+  if (!m_os)
+    {
+      cerr << "Error opening a workload file '" << file_name << "'.\n";
+      exit(1);
+    }
+
+  m_os.write(magic, magic_size);
+}
+
+void
+workload_writer::write(const arrival &a)
+{
+  put(m_os, a.m_t);
+  put(m_os, static_cast<uint32_t>(a.m_d.first.first));
+  put(m_os, static_cast<uint32_t>(a.m_d.first.second));
+  put(m_os, static_cast<uint32_t>(a.m_d.second));
+  put(m_os, a.m_ht);
+}
+
+workload_reader::workload_reader(const string &file_name):
+  m_is(file_name, ios::binary)
+{
+  char buf[magic_size];
+
+  if (!m_is || !m_is.read(buf, magic_size) ||
+      memcmp(buf, magic, magic_size))
+    {
+      cerr << "Error reading a workload file '" << file_name << "'.\n";
+      exit(1);
+    }
+}
+
+bool
+workload_reader::read(arrival &a)
+{
+  uint32_t src, dst, ncu;
+
+  if (get(m_is, a.m_t) && get(m_is, src) && get(m_is, dst) &&
+      get(m_is, ncu) && get(m_is, a.m_ht))
+    {
+      a.m_d = demand(npair(src, dst), ncu);
+      return true;
+    }
+
+  return false;
+}
@@ -0,0 +1,54 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include "graph.hpp"
+
+#include <fstream>
+#include <string>
+
+// The arrival of a demand.
+struct arrival
+{
+  // The arrival time.
+  double m_t;
+  // The demand.
+  demand m_d;
+  // The holding time.
+  double m_ht;
+};
+
+// The workload file is binary.  It starts with the magic string, and
+// then has an arrival per record of 28 bytes: the arrival time (8
+// bytes), the end nodes (2 * 4 bytes), the number of contiguous units
+// (4 bytes), and the holding time (8 bytes).  The file is written and
+// read on the same machine, so the native byte order is used.
+
+// Writes the arrivals to a workload file.
+class workload_writer
+{
+  std::ofstream m_os;
+
+public:
+  // Open the file.  The program exits if the file cannot be opened.
+  workload_writer(const std::string &file_name);
+
+  void
+  write(const arrival &a);
+};
+
+// Reads the arrivals from a workload file.
+class workload_reader
+{
+  std::ifstream m_is;
+
+public:
+  // Open the file.  The program exits if the file cannot be opened,
+  // or is not a workload file.
+  workload_reader(const std::string &file_name);
+
+  // Read the next arrival.  False if there are no more arrivals.
+  bool
+  read(arrival &a);
+};
+
+#endif // WORKLOAD_HPP
@@ -0,0 +1,68 @@
+#include "writer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+using namespace std;
+
+async_writer::async_writer(const string &file_name): m_os(file_name)
+{
+  if (!m_os)
+    {
+      cerr << "Error opening the output file '" << file_name << "'.\n";
+      exit(1);
+    }
+
+  m_thread = thread(&async_writer::run, this);
+}
+
+async_writer::~async_writer()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void
+async_writer::write(const string &text)
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_buf += text;
+  }
+
+  m_cv.notify_one();
+}
+
+void
+async_writer::run()
+{
+  // The text we write.  We swap it with the buffer, so that the
+  // capacity of both strings is reused.
+  string text;
+
+  while(true)
+    {
+      bool stop;
+
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]{return m_stop || !m_buf.empty();});
+        swap(text, m_buf);
+        stop = m_stop;
+      }
+
+      m_os << text;
+      m_os.flush();
+      text.clear();
+
+      // When stopping, we've just written everything there was.
+      if (stop)
+        break;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// The asynchronous writer of text to a file.  The text is appended
+// to a buffer, and a background thread writes the buffer to the file,
+// and flushes the file, so that the file can be followed as it grows.
+// This way the caller doesn't wait for the file operations.
+class async_writer
+{
+  // The output file.
+  std::ofstream m_os;
+
+  // The mutex guarding the buffer and the stop flag.
+  std::mutex m_mutex;
+
+  // Notifies the background thread.
+  std::condition_variable m_cv;
+
+  // The text waiting to be written.
+  std::string m_buf;
+
+  // True if the background thread should finish.
+  bool m_stop = false;
+
+  // The background thread.
+  std::thread m_thread;
+
+public:
+  // Open the file, and start the background thread.  The program
+  // exits if the file cannot be opened.
+  async_writer(const std::string &file_name);
+
+  // Write the remaining text, and stop the background thread.
+  ~async_writer();
+
+  // Append the text to the buffer.
+  void
+  write(const std::string &text);
+
+private:
+  // The function of the background thread.
+  void
+  run();
+};
+
+#endif // WRITER_HPP